@@ -1,6 +1,7 @@
 #ifndef LEADER_FOLLOWERS_HPP
 #define LEADER_FOLLOWERS_HPP
 
+#include <cerrno>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -12,31 +13,42 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <string>
-#include <sstream>
-#include "MSTFactory.hpp"
+#include "Engine.hpp"
+#include "LineBuffer.hpp"
 
-class LeaderFollowersThreadPool {
+class LeaderFollowersThreadPool : public Engine {
 public:
     using Task = std::function<void()>;
 
-    LeaderFollowersThreadPool(size_t numThreads, int listenerSocket)
-        : stop(false), leader(std::thread::id()), listenerSocket(listenerSocket) {
-        for (size_t i = 0; i < numThreads; ++i) {
+    LeaderFollowersThreadPool(const Context& ctx)
+        : Engine(ctx), backlog(ctx.queueLimits), stopping(false), leader(std::thread::id()),
+          listenerSocket(ctx.listenerSocket) {}
+
+    ~LeaderFollowersThreadPool() {
+        stop();
+    }
+
+    void start() override {
+        for (size_t i = 0; i < ctx.numThreads; ++i) {
             threads.emplace_back(&LeaderFollowersThreadPool::workerThread, this);
         }
     }
 
-    ~LeaderFollowersThreadPool() {
+    void stop() override {
         {
             std::unique_lock<std::mutex> lock(queueMutex);
-            stop = true;
+            stopping = true;
         }
         condition.notify_all();
+        shutdownConnections();
         for (std::thread &worker : threads) {
             worker.join();
         }
+        threads.clear();
     }
 
+    std::string name() const override { return "leader-followers"; }
+
     void enqueue(Task task) {
         {
             std::unique_lock<std::mutex> lock(queueMutex);
@@ -45,35 +57,59 @@ public:
         condition.notify_one();
     }
 
+    // Like enqueue, but refuses the task while the queue is over its watermark
+    bool tryEnqueue(Task task) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (backlog.full(tasks.size())) return false;
+            tasks.push(std::move(task));
+        }
+        condition.notify_one();
+        return true;
+    }
+
 private:
     void workerThread() {
+        Topology::active().placeThread();
         while (true) {
             std::unique_lock<std::mutex> lock(queueMutex);
-            condition.wait(lock, [this] { return stop || !tasks.empty() || leader == std::thread::id(); });
+            condition.wait(lock, [this] { return stopping || !tasks.empty() || leader == std::thread::id(); });
 
-            if (stop && tasks.empty()) {
+            if (stopping && tasks.empty()) {
                 return;
             }
 
-            if (leader == std::thread::id()) {
+            // Pending clients come first, otherwise a lone thread would keep re-taking leadership
+            if (!tasks.empty()) {
+                Task task = std::move(tasks.front());
+                tasks.pop();
+                lock.unlock();
+
+                task();
+            } else if (leader == std::thread::id()) {
                 leader = std::this_thread::get_id();
                 lock.unlock();
 
+                // Connections waiting for a thread are bounded; past the watermark they are turned
+                // away with the busy response instead of queueing without limit
                 int newfd = acceptConnection();
-                if (newfd != -1) {
-                    enqueue([this, newfd] { handleClient(newfd); });
+                if (newfd != -1 && !trackConnection(newfd)) {
+                    close(newfd);
+                } else if (newfd != -1) {
+                    ctx.stats.connectionOpened();
+                    if (!tryEnqueue([this, newfd] { handleClient(newfd); })) {
+                        untrackConnection(newfd);
+                        ctx.stats.connectionClosed();
+                        rejectConnection(newfd);
+                    }
                 }
 
                 lock.lock();
                 if (leader == std::this_thread::get_id()) {
                     leader = std::thread::id();
                 }
-            } else if (!tasks.empty()) {
-                Task task = std::move(tasks.front());
-                tasks.pop();
                 lock.unlock();
-
-                task();
+                condition.notify_one();
             }
         }
     }
@@ -82,76 +118,58 @@ private:
         sockaddr_storage remoteaddr;
         socklen_t addrlen = sizeof remoteaddr;
         int newfd = accept(listenerSocket, (struct sockaddr *)&remoteaddr, &addrlen);
-        if (newfd == -1) {
+        // EINVAL: the server shut the listener down and stop() is about to follow
+        if (newfd == -1 && !stopping && errno != EINVAL) {
             perror("accept");
         }
         return newfd;
     }
 
     void handleClient(int fd) {
-        std::string buffer;
-        char buf[256];
+        LineBuffer buffer;
         while (true) {
-            int nbytes = recv(fd, buf, sizeof buf, 0);
+            char* space = buffer.space();
+            ssize_t nbytes = recv(fd, space, buffer.spaceSize(), 0);
             if (nbytes <= 0) {
                 if (nbytes == 0) {
-                    std::cout << "Socket " << fd << " hung up\n";
-                } else {
+                    if (ctx.verbose) std::cout << "Socket " << fd << " hung up\n";
+                } else if (!stopping) {
                     perror("recv");
                 }
-                close(fd);
-                return;
+                break;
             }
-            buffer.append(buf, nbytes);
-            size_t pos;
-            while ((pos = buffer.find('\n')) != std::string::npos) {
-                std::string command = buffer.substr(0, pos);
-                buffer.erase(0, pos + 1);
-                std::cout << "Client " << fd << " - Received command: " << command << std::endl;
-                std::vector<std::string> data = g.parse(command);
-                std::lock_guard<std::mutex> lock(graph_mutex);
-                std::string result;
-                bool success = g.eval(data);
-                if (success) {
-                    result = "Command processed successfully\n";
-                    if (data[0] == "RunMST") {
-                        const std::string& algorithm = data[1];
-                        try {
-                            auto mstAlgorithm = MSTFactory::createAlgorithm(algorithm);
-                            MST mst = mstAlgorithm->solve(g);
-                            mst.calculateDistances();
-                            std::ostringstream oss;
-                            oss << "MST total weight: " << mst.getTotalWeight() << "\n";
-                            oss << "Longest distance: " << mst.getLongestDistance() << "\n";
-                            oss << "Average distance: " << mst.getAverageDistance() << "\n";
-                            oss << "Shortest distance: " << mst.getShortestDistance() << "\n";
-                            result += oss.str();
-                        } catch (const std::exception& e) {
-                            result = "Error running MST algorithm: " + std::string(e.what()) + "\n";
-                            success = false;
-                        }
-                    }
-                } else {
-                    result = "Command processing failed\n";
-                }
-                send(fd, result.c_str(), result.length(), 0);
-                
-                std::cout << "Client " << fd << " - Sent response: " << result;
-                if (!success) std::cerr << "exit" << std::endl;
+            ctx.stats.bytesReceived(nbytes);
+            buffer.commit(nbytes);
+            std::string_view command;
+            while (buffer.nextLine(command)) {
+                auto start = Instrumentation::Clock::now();
+                if (ctx.verbose) std::cout << "Client " << fd << " - Received command: " << command << std::endl;
+                std::vector<std::string> data = ctx.processor.parse(command);
+                CommandProcessor::Response response = ctx.processor.execute(data);
+                sendAll(fd, response);
+                ctx.stats.recordCommand(data.empty() ? "" : data[0], start, response.ok);
+
+                if (ctx.verbose) std::cout << "Client " << fd << " - Sent response: " << response.text;
+            }
+            if (buffer.overlong()) {
+                ctx.stats.lineTooLong();
+                sendAll(fd, LINE_TOO_LONG_RESPONSE);
+                break;
             }
         }
+        untrackConnection(fd);
+        ctx.stats.connectionClosed();
+        close(fd);
     }
 
     std::vector<std::thread> threads;
     std::queue<Task> tasks;
+    Watermark backlog;
     std::mutex queueMutex;
     std::condition_variable condition;
-    std::atomic<bool> stop;
+    std::atomic<bool> stopping;
     std::atomic<std::thread::id> leader;
     int listenerSocket;
-
-    Graph g;
-    std::mutex graph_mutex;
 };
 
-#endif // LEADER_FOLLOWERS_HPP
\ No newline at end of file
+#endif // LEADER_FOLLOWERS_HPP
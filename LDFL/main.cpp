@@ -1,8 +0,0 @@
-#include "Server.hpp"
-#include <iostream>
-
-int main() {
-    Server server;
-    server.run();
-    return 0;
-}
\ No newline at end of file
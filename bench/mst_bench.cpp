@@ -0,0 +1,200 @@
+// Calibrates the RunMST Auto cost model on this machine.
+//
+// Times every algorithm on a grid of random graphs (size, density, weight range, degree skew),
+// fits each algorithm's cost coefficients by least squares on relative error, and writes a model
+// file for `mst_server --cost-model`.
+
+#include "BoruvkaKernels.hpp"
+#include "CostModel.hpp"
+#include "Graph.hpp"
+#include "MSTFactory.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Sample {
+    CostModel::Features features;
+    double ns[CostModel::NUM_ALGORITHMS];
+};
+
+void buildGraph(Graph& graph, int n, int averageDegree, int weightRange, bool skewed, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(1, n);
+    std::uniform_int_distribution<int> hub(1, std::max(1, n / 1000));
+    std::uniform_int_distribution<int> weight(0, weightRange - 1);
+    size_t m = static_cast<size_t>(n) * averageDegree / 2;
+    graph.NewGraph(n, static_cast<int>(m));
+    for (size_t k = 0; k < m; ++k) {
+        // Skewed graphs attach half of their edges to a few hub vertices
+        int u = skewed && (k & 1) ? hub(rng) : vertex(rng);
+        graph.NewEdge(u, vertex(rng), weight(rng));
+    }
+}
+
+double timeSolve(MSTAlgorithm& algorithm, const Graph& graph, int repeats) {
+    SolverWorkspace& workspace = SolverWorkspace::forThisThread();
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        algorithm.solve(graph, workspace, workspace.result);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// Solves the normal equations A^T A x = A^T b by Gaussian elimination with partial pivoting,
+// restricted to the features in `active`
+std::vector<double> leastSquares(const std::vector<std::vector<double>>& rows, const std::vector<double>& targets,
+                                 const std::vector<int>& active) {
+    size_t k = active.size();
+    std::vector<std::vector<double>> a(k, std::vector<double>(k + 1, 0.0));
+    for (size_t r = 0; r < rows.size(); ++r) {
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < k; ++j) a[i][j] += rows[r][active[i]] * rows[r][active[j]];
+            a[i][k] += rows[r][active[i]] * targets[r];
+        }
+    }
+    for (size_t col = 0; col < k; ++col) {
+        size_t pivot = col;
+        for (size_t i = col + 1; i < k; ++i) {
+            if (std::fabs(a[i][col]) > std::fabs(a[pivot][col])) pivot = i;
+        }
+        std::swap(a[col], a[pivot]);
+        if (std::fabs(a[col][col]) < 1e-12) continue;
+        for (size_t i = 0; i < k; ++i) {
+            if (i == col) continue;
+            double factor = a[i][col] / a[col][col];
+            for (size_t j = col; j <= k; ++j) a[i][j] -= factor * a[col][j];
+        }
+    }
+    std::vector<double> x(k, 0.0);
+    for (size_t i = 0; i < k; ++i) {
+        if (std::fabs(a[i][i]) >= 1e-12) x[i] = a[i][k] / a[i][i];
+    }
+    return x;
+}
+
+// Non-negative fit: features whose coefficient comes out negative are dropped and the rest refit.
+// Each row is scaled by 1 / measured time, so the fit minimizes relative error.
+CostModel::Features fit(const std::vector<Sample>& samples, size_t algorithm, const std::vector<int>& candidates) {
+    std::vector<std::vector<double>> rows;
+    std::vector<double> targets;
+    for (const Sample& s : samples) {
+        double scale = 1.0 / s.ns[algorithm];
+        std::vector<double> row(CostModel::NUM_FEATURES);
+        for (int f = 0; f < CostModel::NUM_FEATURES; ++f) row[f] = s.features[f] * scale;
+        rows.push_back(row);
+        targets.push_back(1.0);
+    }
+
+    std::vector<int> active = candidates;
+    std::vector<double> x;
+    while (!active.empty()) {
+        x = leastSquares(rows, targets, active);
+        auto negative = std::min_element(x.begin(), x.end());
+        if (*negative >= 0) break;
+        active.erase(active.begin() + (negative - x.begin()));
+    }
+
+    CostModel::Features c{};
+    for (size_t i = 0; i < active.size(); ++i) c[active[i]] = x[i];
+    return c;
+}
+
+void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "  --out FILE        write the fitted model (default cost_model.txt)\n"
+              << "  --scale F         multiply graph sizes by F (default 1)\n"
+              << "  --repeats N       timed runs per algorithm and graph, best kept (default 3)\n"
+              << "  --threads N       solver threads (default: all cores)\n"
+              << "  --simd LEVEL      Boruvka kernel: auto (default), avx512, avx2, scalar\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string out = "cost_model.txt";
+    double scale = 1.0;
+    int repeats = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (arg == "--out") {
+            out = argv[++i];
+        } else if (arg == "--scale") {
+            scale = std::stod(argv[++i]);
+        } else if (arg == "--repeats") {
+            repeats = std::stoi(argv[++i]);
+        } else if (arg == "--simd") {
+            if (!BoruvkaKernels::force(argv[++i])) {
+                std::cerr << "SIMD level " << argv[i] << " is not supported on this CPU\n";
+                return 1;
+            }
+        } else if (arg == "--threads") {
+            ThreadPool::configure(std::stoul(argv[++i]));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<MSTAlgorithm>> algorithms;
+    for (const char* name : CostModel::ALGORITHMS) algorithms.push_back(MSTFactory::createAlgorithm(name));
+
+    std::cout << "Boruvka kernel: " << BoruvkaKernels::name() << "\n";
+    std::cout << std::setw(8) << "n" << std::setw(5) << "deg" << std::setw(9) << "range" << std::setw(6) << "skew";
+    for (const char* name : CostModel::ALGORITHMS) std::cout << std::setw(11) << name;
+    std::cout << "   (ms)\n";
+
+    std::vector<Sample> samples;
+    uint32_t seed = 1;
+    Graph graph;
+    for (int baseN : {2000, 20000, 100000}) {
+        for (int degree : {4, 16}) {
+            for (int range : {100, 1000000}) {
+                for (bool skewed : {false, true}) {
+                    int n = std::max(10, static_cast<int>(baseN * scale));
+                    buildGraph(graph, n, degree, range, skewed, seed++);
+                    Sample s;
+                    s.features = CostModel::features(graph);
+                    std::cout << std::setw(8) << n << std::setw(5) << degree << std::setw(9) << range
+                              << std::setw(6) << (skewed ? "yes" : "no");
+                    for (size_t a = 0; a < algorithms.size(); ++a) {
+                        s.ns[a] = timeSolve(*algorithms[a], graph, repeats);
+                        std::cout << std::setw(11) << std::fixed << std::setprecision(2) << s.ns[a] / 1e6;
+                    }
+                    std::cout << "\n";
+                    samples.push_back(s);
+                }
+            }
+        }
+    }
+
+    CostModel model;
+    for (size_t a = 0; a < CostModel::NUM_ALGORITHMS; ++a) {
+        // Only the counting sort pays per unit of weight range
+        std::vector<int> candidates{CostModel::EDGES, CostModel::EDGES_LOG_EDGES, CostModel::VERTICES,
+                                    CostModel::EDGES_LOG_SKEW};
+        if (std::string(CostModel::ALGORITHMS[a]) == "Integer") candidates.push_back(CostModel::WEIGHT_RANGE);
+        model.setCoefficients(a, fit(samples, a, candidates));
+    }
+
+    if (!model.save(out)) {
+        std::cerr << "Failed to write " << out << "\n";
+        return 1;
+    }
+    std::cout << "Cost model written to " << out << "\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "BoruvkaKernels.hpp"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MST_X86_KERNELS 1
+#endif
+
+namespace {
+
+size_t compactScalar(int* from, int* to, int* weight, int* id, size_t count, const int* component) {
+    size_t kept = 0;
+    for (size_t k = 0; k < count; ++k) {
+        int a = component[from[k]];
+        int b = component[to[k]];
+        if (a == b) continue;
+        from[kept] = a;
+        to[kept] = b;
+        weight[kept] = weight[k];
+        id[kept] = id[k];
+        ++kept;
+    }
+    return kept;
+}
+
+#ifdef MST_X86_KERNELS
+
+// Lane permutation that moves the lanes set in an 8-bit mask to the front, in order
+struct CompressTable {
+    alignas(32) int lanes[256][8];
+
+    CompressTable() {
+        for (int mask = 0; mask < 256; ++mask) {
+            int out = 0;
+            for (int lane = 0; lane < 8; ++lane) {
+                if (mask & (1 << lane)) lanes[mask][out++] = lane;
+            }
+            while (out < 8) lanes[mask][out++] = 0;
+        }
+    }
+};
+const CompressTable compressTable;
+
+// Stores never overtake loads: output position <= k and each block is loaded before it is stored
+__attribute__((target("avx2")))
+size_t compactAvx2(int* from, int* to, int* weight, int* id, size_t count, const int* component) {
+    size_t kept = 0;
+    size_t k = 0;
+    for (; k + 8 <= count; k += 8) {
+        __m256i a = _mm256_i32gather_epi32(component, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + k)), 4);
+        __m256i b = _mm256_i32gather_epi32(component, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + k)), 4);
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weight + k));
+        __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(id + k));
+        int keep = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))) & 0xff;
+        __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i*>(compressTable.lanes[keep]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(from + kept), _mm256_permutevar8x32_epi32(a, perm));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(to + kept), _mm256_permutevar8x32_epi32(b, perm));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(weight + kept), _mm256_permutevar8x32_epi32(w, perm));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(id + kept), _mm256_permutevar8x32_epi32(e, perm));
+        kept += __builtin_popcount(keep);
+    }
+    for (; k < count; ++k) {
+        int a = component[from[k]];
+        int b = component[to[k]];
+        if (a == b) continue;
+        from[kept] = a;
+        to[kept] = b;
+        weight[kept] = weight[k];
+        id[kept] = id[k];
+        ++kept;
+    }
+    return kept;
+}
+
+__attribute__((target("avx512f")))
+size_t compactAvx512(int* from, int* to, int* weight, int* id, size_t count, const int* component) {
+    size_t kept = 0;
+    size_t k = 0;
+    for (; k + 16 <= count; k += 16) {
+        __m512i a = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xffff, _mm512_loadu_si512(from + k), component, 4);
+        __m512i b = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xffff, _mm512_loadu_si512(to + k), component, 4);
+        __m512i w = _mm512_loadu_si512(weight + k);
+        __m512i e = _mm512_loadu_si512(id + k);
+        __mmask16 keep = _mm512_cmpneq_epi32_mask(a, b);
+        _mm512_mask_compressstoreu_epi32(from + kept, keep, a);
+        _mm512_mask_compressstoreu_epi32(to + kept, keep, b);
+        _mm512_mask_compressstoreu_epi32(weight + kept, keep, w);
+        _mm512_mask_compressstoreu_epi32(id + kept, keep, e);
+        kept += __builtin_popcount(keep);
+    }
+    // Masked tail: the remaining lanes are loaded and gathered under a mask
+    if (k < count) {
+        __mmask16 live = static_cast<__mmask16>((1u << (count - k)) - 1);
+        __m512i a = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, _mm512_maskz_loadu_epi32(live, from + k), component, 4);
+        __m512i b = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, _mm512_maskz_loadu_epi32(live, to + k), component, 4);
+        __m512i w = _mm512_maskz_loadu_epi32(live, weight + k);
+        __m512i e = _mm512_maskz_loadu_epi32(live, id + k);
+        __mmask16 keep = _mm512_mask_cmpneq_epi32_mask(live, a, b);
+        _mm512_mask_compressstoreu_epi32(from + kept, keep, a);
+        _mm512_mask_compressstoreu_epi32(to + kept, keep, b);
+        _mm512_mask_compressstoreu_epi32(weight + kept, keep, w);
+        _mm512_mask_compressstoreu_epi32(id + kept, keep, e);
+        kept += __builtin_popcount(keep);
+    }
+    return kept;
+}
+
+#endif // MST_X86_KERNELS
+
+} // namespace
+
+BoruvkaKernels::Variant BoruvkaKernels::detect() {
+#ifdef MST_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return {compactAvx512, "avx512"};
+    if (__builtin_cpu_supports("avx2")) return {compactAvx2, "avx2"};
+#endif
+    return {compactScalar, "scalar"};
+}
+
+bool BoruvkaKernels::force(const std::string& level) {
+    if (level == "auto") {
+        selected() = detect();
+        return true;
+    }
+    if (level == "scalar") {
+        selected() = {compactScalar, "scalar"};
+        return true;
+    }
+#ifdef MST_X86_KERNELS
+    __builtin_cpu_init();
+    if (level == "avx512" && __builtin_cpu_supports("avx512f")) {
+        selected() = {compactAvx512, "avx512"};
+        return true;
+    }
+    if (level == "avx2" && __builtin_cpu_supports("avx2")) {
+        selected() = {compactAvx2, "avx2"};
+        return true;
+    }
+#endif
+    return false;
+}
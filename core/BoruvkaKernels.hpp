@@ -0,0 +1,36 @@
+#ifndef BORUVKA_KERNELS_HPP
+#define BORUVKA_KERNELS_HPP
+
+#include <cstddef>
+#include <string>
+
+// Per-round edge compaction for Boruvka over a structure-of-arrays edge list.
+// Each kernel relabels both endpoints of every edge to their current component
+// (label[k] = component[label[k]]) and drops edges that now lie inside one component, compacting
+// all four arrays in place and in order. Returns the number of edges kept.
+//
+// The AVX2 and AVX-512 versions gather labels 8 or 16 edges at a time and compact with a
+// permutation table or compress-stores. The variant is picked once from the running CPU.
+class BoruvkaKernels {
+public:
+    using CompactFn = size_t (*)(int* from, int* to, int* weight, int* id, size_t count, const int* component);
+
+    static CompactFn compact() { return selected().fn; }
+    static const char* name() { return selected().name; }
+
+    // "auto", "avx512", "avx2" or "scalar"; false if unknown or unsupported by this CPU
+    static bool force(const std::string& level);
+
+private:
+    struct Variant {
+        CompactFn fn;
+        const char* name;
+    };
+    static Variant detect();
+    static Variant& selected() {
+        static Variant variant = detect();
+        return variant;
+    }
+};
+
+#endif // BORUVKA_KERNELS_HPP
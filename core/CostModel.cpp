@@ -0,0 +1,91 @@
+#include "CostModel.hpp"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+CostModel::CostModel() {
+    //                                 m     m log m   n     range  m log skew
+    coefficients[0] = Features{{12.0,  1.5,  20.0,  0.0,  0.0}};  // Boruvka
+    coefficients[1] = Features{{ 4.0,  2.5,  15.0,  0.0,  1.0}};  // Prim
+    coefficients[2] = Features{{ 6.0,  1.2,  12.0,  0.0,  0.0}};  // Kruskal
+    coefficients[3] = Features{{ 6.0,  1.2,  12.0,  0.0,  0.0}};  // Tarjan
+    coefficients[4] = Features{{10.0,  0.0,  12.0,  1.0,  0.0}};  // Integer
+}
+
+CostModel::Features CostModel::features(int vertices, size_t edges, long long weightRange, size_t maxDegree) {
+    double m = static_cast<double>(edges);
+    double n = static_cast<double>(vertices);
+    double averageDegree = n > 0 ? m / n : 0.0;
+    double skew = averageDegree > 0 ? static_cast<double>(maxDegree) / averageDegree : 1.0;
+    return Features{{m, m * std::log2(m + 1), n, static_cast<double>(weightRange), m * std::log2(1.0 + skew)}};
+}
+
+CostModel::Features CostModel::features(const Graph& graph) {
+    const Graph::ShapeStats& shape = graph.getShapeStats();
+    long long range = shape.hasEdges ? static_cast<long long>(shape.maxWeight) - shape.minWeight + 1 : 0;
+    return features(graph.getNumVertices(), graph.getNumEdges(), range, shape.maxDegree);
+}
+
+double CostModel::estimate(size_t algorithm, const Features& f) const {
+    double cost = 0.0;
+    for (int k = 0; k < NUM_FEATURES; ++k) {
+        cost += coefficients[algorithm][k] * f[k];
+    }
+    return cost;
+}
+
+std::string CostModel::choose(const Graph& graph) const {
+    Features f = features(graph);
+    bool integerWeights = graph.getShapeStats().minWeight >= 0;
+    size_t best = 0;
+    double bestCost = std::numeric_limits<double>::max();
+    for (size_t a = 0; a < NUM_ALGORITHMS; ++a) {
+        if (std::string(ALGORITHMS[a]) == "Integer" && !integerWeights) continue;
+        double cost = estimate(a, f);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = a;
+        }
+    }
+    return ALGORITHMS[best];
+}
+
+bool CostModel::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cost model: cannot open " << path << "\n";
+        return false;
+    }
+    std::array<Features, NUM_ALGORITHMS> loaded = coefficients;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string name;
+        Features c;
+        iss >> name;
+        for (double& value : c) iss >> value;
+        size_t a = 0;
+        while (a < NUM_ALGORITHMS && name != ALGORITHMS[a]) ++a;
+        if (!iss || a == NUM_ALGORITHMS) {
+            std::cerr << "Cost model: bad line in " << path << ": " << line << "\n";
+            return false;
+        }
+        loaded[a] = c;
+    }
+    coefficients = loaded;
+    return true;
+}
+
+bool CostModel::save(const std::string& path) const {
+    std::ofstream out(path);
+    out << "# ns per unit of: edges, edges*log2(edges), vertices, weight range, edges*log2(1+degree skew)\n";
+    for (size_t a = 0; a < NUM_ALGORITHMS; ++a) {
+        out << ALGORITHMS[a];
+        for (double value : coefficients[a]) out << ' ' << value;
+        out << '\n';
+    }
+    return static_cast<bool>(out);
+}
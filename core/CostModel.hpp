@@ -0,0 +1,46 @@
+#ifndef COST_MODEL_HPP
+#define COST_MODEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include "Graph.hpp"
+
+// Linear cost model behind RunMST Auto. Every algorithm's run time is predicted as a weighted sum
+// of graph features; the coefficients are nanoseconds per unit of each feature. The defaults are
+// rough; mst_bench fits them on the deployment machine and writes a file for --cost-model.
+class CostModel {
+public:
+    enum Feature { EDGES, EDGES_LOG_EDGES, VERTICES, WEIGHT_RANGE, EDGES_LOG_SKEW, NUM_FEATURES };
+    using Features = std::array<double, NUM_FEATURES>;
+
+    static constexpr size_t NUM_ALGORITHMS = 5;
+    static constexpr const char* ALGORITHMS[NUM_ALGORITHMS] = {"Boruvka", "Prim", "Kruskal", "Tarjan", "Integer"};
+
+    CostModel();
+
+    static Features features(int vertices, size_t edges, long long weightRange, size_t maxDegree);
+    static Features features(const Graph& graph);
+
+    double estimate(size_t algorithm, const Features& f) const;
+    // Cheapest algorithm that can run on this graph (Integer needs non-negative weights)
+    std::string choose(const Graph& graph) const;
+
+    void setCoefficients(size_t algorithm, const Features& c) { coefficients[algorithm] = c; }
+    const Features& getCoefficients(size_t algorithm) const { return coefficients[algorithm]; }
+
+    // One line per algorithm: name followed by NUM_FEATURES coefficients. Lines starting with # are comments.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // Model used by RunMST Auto; replaced at startup by --cost-model
+    static CostModel& active() {
+        static CostModel model;
+        return model;
+    }
+
+private:
+    std::array<Features, NUM_ALGORITHMS> coefficients;
+};
+
+#endif // COST_MODEL_HPP
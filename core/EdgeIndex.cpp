@@ -0,0 +1,74 @@
+#include "EdgeIndex.hpp"
+
+EdgeIndex::EdgeIndex() : mask(0), count(0) {}
+
+void EdgeIndex::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    mask = 0;
+    count = 0;
+}
+
+void EdgeIndex::reserve(size_t edges) {
+    size_t capacity = 16;
+    while (capacity < edges * 2) capacity <<= 1;
+    if (capacity > slots.size()) grow(capacity);
+}
+
+// Slot holding key, or the empty slot where it would go
+size_t EdgeIndex::probe(uint64_t key) const {
+    size_t i = hash(key) & mask;
+    while (slots[i].key != EMPTY && slots[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+uint32_t EdgeIndex::find(int u, int v) const {
+    if (count == 0) return NOT_FOUND;
+    const Slot& slot = slots[probe(pack(u, v))];
+    return slot.key == EMPTY ? NOT_FOUND : slot.position;
+}
+
+void EdgeIndex::assign(int u, int v, uint32_t position) {
+    if ((count + 1) * 2 > slots.size()) grow(slots.empty() ? 16 : slots.size() * 2);
+    uint64_t key = pack(u, v);
+    Slot& slot = slots[probe(key)];
+    if (slot.key == EMPTY) {
+        slot.key = key;
+        ++count;
+    }
+    slot.position = position;
+}
+
+void EdgeIndex::erase(int u, int v) {
+    if (count == 0) return;
+    size_t hole = probe(pack(u, v));
+    if (slots[hole].key == EMPTY) return;
+    --count;
+
+    // Shift later members of the probe run back into the hole so no run is broken
+    size_t i = hole;
+    while (true) {
+        i = (i + 1) & mask;
+        if (slots[i].key == EMPTY) break;
+        size_t home = hash(slots[i].key) & mask;
+        // Movable unless its home lies cyclically in (hole, i]
+        bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole].key = EMPTY;
+}
+
+void EdgeIndex::grow(size_t newCapacity) {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(newCapacity, Slot{EMPTY, 0});
+    mask = newCapacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.key != EMPTY) slots[probe(slot.key)] = slot;
+    }
+}
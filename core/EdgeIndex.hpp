@@ -0,0 +1,52 @@
+#ifndef EDGE_INDEX_HPP
+#define EDGE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map from an edge (u, v) to its position in adj[u]. Keys are taken as given;
+// Graph passes undirected edges with u < v.
+// Linear probing with backward-shift deletion, so there are no tombstones and lookups stay
+// short after many removals. Capacity is a power of two kept at most half full.
+class EdgeIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    EdgeIndex();
+
+    void clear();
+    void reserve(size_t edges);
+    size_t size() const { return count; }
+
+    // Position of (u, v) in adj[u], or NOT_FOUND
+    uint32_t find(int u, int v) const;
+    // Inserts (u, v) or moves it to a new position
+    void assign(int u, int v, uint32_t position);
+    void erase(int u, int v);
+
+private:
+    struct Slot {
+        uint64_t key;
+        uint32_t position;
+    };
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    static uint64_t pack(int u, int v) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(u)) << 32) | static_cast<uint32_t>(v);
+    }
+    static uint64_t hash(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+    size_t probe(uint64_t key) const;
+    void grow(size_t newCapacity);
+
+    std::vector<Slot> slots;
+    size_t mask;
+    size_t count;
+};
+
+#endif // EDGE_INDEX_HPP
@@ -0,0 +1,376 @@
+#include "EulerTour.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+namespace {
+
+// Calls body(c, begin, end) for each run of positions in [chunkBegin, chunkEnd) that lies in tree c
+template <typename F>
+void forEachTreeRun(const size_t* starts, int numTrees, size_t chunkBegin, size_t chunkEnd, F&& body) {
+    int c = static_cast<int>(std::upper_bound(starts, starts + numTrees + 1, chunkBegin) - starts) - 1;
+    size_t p = chunkBegin;
+    while (p < chunkEnd) {
+        while (starts[c + 1] <= p) ++c;
+        size_t end = std::min(chunkEnd, starts[c + 1]);
+        body(c, p, end);
+        p = end;
+    }
+}
+
+// In-place inclusive prefix sum: per-chunk totals in parallel, chunk offsets serially, then a
+// parallel pass adding each chunk's offset
+void parallelInclusiveScan(int64_t* data, size_t count, Arena& arena, ThreadPool& pool) {
+    if (count == 0) return;
+    size_t chunks = std::min(count, pool.size() * 4);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    int64_t* totals = arena.allocate<int64_t>(chunks);
+    pool.parallelFor(chunks, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            int64_t sum = 0;
+            for (size_t p = k * chunkSize; p < std::min(count, (k + 1) * chunkSize); ++p) {
+                sum += data[p];
+                data[p] = sum;
+            }
+            totals[k] = sum;
+        }
+    }, 1);
+    int64_t carry = 0;
+    for (size_t k = 0; k < chunks; ++k) {
+        int64_t total = totals[k];
+        totals[k] = carry;
+        carry += total;
+    }
+    pool.parallelFor(chunks, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            for (size_t p = k * chunkSize; p < std::min(count, (k + 1) * chunkSize); ++p) data[p] += totals[k];
+        }
+    }, 1);
+}
+
+} // namespace
+
+void EulerTour::build(const MST& forest, Arena& arena, ThreadPool& pool) {
+    Arena::Scope scope(arena);
+    const std::vector<MSTEdge>& edges = forest.getEdges();
+    n = forest.getNumVertices();
+    size_t numArcs = 2 * edges.size();
+
+    // Arcs grouped by tail vertex; edge i owns one slot in each endpoint's range
+    offsets.assign(n + 1, 0);
+    for (const MSTEdge& e : edges) {
+        ++offsets[e.from + 1];
+        ++offsets[e.to + 1];
+    }
+    for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+    target.resize(numArcs);
+    weight.resize(numArcs);
+    twin.resize(numArcs);
+    size_t* fill = arena.allocate<size_t>(n);
+    std::copy(offsets.begin(), offsets.end() - 1, fill);
+    for (const MSTEdge& e : edges) {
+        size_t a = fill[e.from]++;
+        size_t b = fill[e.to]++;
+        target[a] = e.to;
+        target[b] = e.from;
+        weight[a] = weight[b] = e.weight;
+        twin[a] = static_cast<int>(b);
+        twin[b] = static_cast<int>(a);
+    }
+
+    // Trees in order of their lowest vertex, as the forest solver reports them
+    roots.clear();
+    starts.clear();
+    size_t base = 0;
+    if (!forest.getComponents().empty() || n == 0) {
+        for (const ComponentStats& tree : forest.getComponents()) {
+            roots.push_back(tree.root);
+            starts.push_back(base);
+            base += 2 * static_cast<size_t>(tree.vertices - 1);
+        }
+    } else {
+        // A forest filled edge by edge has no tree list; find the trees with a union-find whose
+        // representatives are always the lowest vertex
+        int* parent = arena.allocate<int>(n);
+        int* count = arena.allocate<int>(n);
+        for (int v = 0; v < n; ++v) {
+            parent[v] = v;
+            count[v] = 0;
+        }
+        auto find = [parent](int v) {
+            while (parent[v] != v) v = parent[v] = parent[parent[v]];
+            return v;
+        };
+        for (const MSTEdge& e : edges) {
+            int a = find(e.from), b = find(e.to);
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+        for (int v = 0; v < n; ++v) ++count[find(v)];
+        for (int v = 0; v < n; ++v) {
+            if (parent[v] != v) continue;
+            roots.push_back(v);
+            starts.push_back(base);
+            base += 2 * static_cast<size_t>(count[v] - 1);
+        }
+    }
+    starts.push_back(base);
+
+    // Successor in the tour: after entering v through arc a, leave v by the arc following a's
+    // twin in v's list. Each tree's cycle is cut where it returns to its root.
+    int* next = arena.allocate<int>(numArcs);
+    pool.parallelFor(numArcs, [&](size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            int v = target[a];
+            size_t b = twin[a] + 1;
+            next[a] = static_cast<int>(b < offsets[v + 1] ? b : offsets[v]);
+        }
+    });
+    for (int root : roots) {
+        if (offsets[root] != offsets[root + 1]) next[twin[offsets[root + 1] - 1]] = -1;
+    }
+
+    // List ranking over sublists: every tree's first arc plus evenly spaced arcs split the tours
+    // into pieces that threads walk independently; pieces are then chained serially (there are
+    // few of them) and every arc gets piece base + offset within its piece.
+    size_t stride = std::max<size_t>(64, numArcs / (pool.size() * 64));
+    int* pieceOf = arena.allocate<int>(numArcs);
+    std::fill(pieceOf, pieceOf + numArcs, -1);
+    int* pieceHead = arena.allocate<int>(roots.size() + numArcs / stride + 1);
+    size_t pieces = 0;
+    for (int root : roots) {
+        if (offsets[root] != offsets[root + 1]) pieceHead[pieces++] = static_cast<int>(offsets[root]);
+    }
+    size_t treesWithArcs = pieces;
+    for (size_t a = 0; a < numArcs; a += stride) pieceHead[pieces++] = static_cast<int>(a);
+    for (size_t s = 0; s < pieces; ++s) {
+        // A spaced arc that is also a tree head is already listed
+        if (pieceOf[pieceHead[s]] == -1) pieceOf[pieceHead[s]] = static_cast<int>(s);
+        else pieceHead[s] = -1;
+    }
+
+    int* local = arena.allocate<int>(numArcs);
+    int* owner = arena.allocate<int>(numArcs);
+    int* pieceNext = arena.allocate<int>(pieces);
+    size_t* pieceLength = arena.allocate<size_t>(pieces);
+    size_t* pieceBase = arena.allocate<size_t>(pieces);
+    pool.parallelFor(pieces, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            pieceNext[s] = -1;
+            pieceLength[s] = 0;
+            if (pieceHead[s] == -1) continue;
+            int a = pieceHead[s];
+            int rank = 0;
+            while (true) {
+                local[a] = rank++;
+                owner[a] = static_cast<int>(s);
+                int b = next[a];
+                if (b == -1) break;
+                if (pieceOf[b] != -1) {
+                    pieceNext[s] = pieceOf[b];
+                    break;
+                }
+                a = b;
+            }
+            pieceLength[s] = rank;
+        }
+    }, 1);
+
+    for (size_t t = 0, c = 0; t < treesWithArcs; ++t) {
+        while (offsets[roots[c]] == offsets[roots[c] + 1]) ++c;
+        size_t at = starts[c++];
+        for (int s = static_cast<int>(t); s != -1; s = pieceNext[s]) {
+            pieceBase[s] = at;
+            at += pieceLength[s];
+        }
+    }
+
+    position.resize(numArcs);
+    order.resize(numArcs);
+    depth.resize(numArcs);
+    pool.parallelFor(numArcs, [&](size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            size_t p = pieceBase[owner[a]] + local[a];
+            position[a] = p;
+            order[p] = static_cast<int>(a);
+        }
+    });
+
+    // Going down adds the edge weight, coming back up subtracts it; each tree sums to zero, so one
+    // scan over all tours gives every tree's depths from its own root
+    pool.parallelFor(numArcs, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            int a = order[p];
+            depth[p] = position[a] < position[twin[a]] ? weight[a] : -static_cast<int64_t>(weight[a]);
+        }
+    });
+    parallelInclusiveScan(depth.data(), numArcs, arena, pool);
+
+    first.assign(n, -1);
+    component.resize(n);
+    for (size_t c = 0; c < roots.size(); ++c) component[roots[c]] = static_cast<int>(c);
+    pool.parallelFor(numArcs, [&](size_t begin, size_t end) {
+        forEachTreeRun(starts.data(), getNumComponents(), begin, end, [&](int c, size_t from, size_t to) {
+            for (size_t p = from; p < to; ++p) {
+                int a = order[p];
+                if (position[a] < position[twin[a]]) {
+                    first[target[a]] = static_cast<int64_t>(p);
+                    component[target[a]] = c;
+                }
+            }
+        });
+    });
+}
+
+namespace {
+
+// Max of d_i - 2 d_j + d_k over i <= j <= k in a run of depths. With non-negative weights the
+// shallowest vertex between two tour visits is their LCA, so the best triple is the longest path.
+struct PathSummary {
+    int64_t maxDepth;      // max d
+    int64_t maxMinus2;     // max -2 d
+    int64_t left;          // max d_i - 2 d_j, i <= j
+    int64_t right;         // max -2 d_j + d_k, j <= k
+    int64_t best;          // max d_i - 2 d_j + d_k
+
+    static PathSummary of(int64_t d) { return {d, -2 * d, -d, -d, 0}; }
+
+    PathSummary then(const PathSummary& y) const {
+        return {std::max(maxDepth, y.maxDepth),
+                std::max(maxMinus2, y.maxMinus2),
+                std::max({left, y.left, maxDepth + y.maxMinus2}),
+                std::max({right, y.right, maxMinus2 + y.maxDepth}),
+                std::max({best, y.best, left + y.maxDepth, maxDepth + y.right})};
+    }
+};
+
+} // namespace
+
+TreeMetrics computeTreeMetrics(const EulerTour& tour, Arena& arena, ThreadPool& pool) {
+    Arena::Scope scope(arena);
+    size_t numArcs = tour.size();
+    int numTrees = tour.getNumComponents();
+    size_t* starts = arena.allocate<size_t>(numTrees + 1);
+    for (int c = 0; c < numTrees; ++c) starts[c] = tour.componentStart(c);
+    starts[numTrees] = numArcs;
+
+    // Each chunk reports its partial pair sum and whether it saw a negative weight
+    size_t chunks = std::min<size_t>(std::max<size_t>(numArcs, 1), pool.size() * 4);
+    size_t chunkSize = (numArcs + chunks - 1) / chunks;
+    long double* chunkSum = arena.allocate<long double>(chunks);
+    bool* chunkNegative = arena.allocate<bool>(chunks);
+    pool.parallelFor(chunks, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            long double sum = 0;
+            bool negative = false;
+            size_t from = std::min(numArcs, k * chunkSize), to = std::min(numArcs, (k + 1) * chunkSize);
+            forEachTreeRun(starts, numTrees, from, to, [&](int c, size_t runFrom, size_t runTo) {
+                long double vertices = static_cast<long double>(starts[c + 1] - starts[c]) / 2 + 1;
+                for (size_t p = runFrom; p < runTo; ++p) {
+                    if (!tour.downAt(p)) continue;
+                    int a = tour.arcAt(p);
+                    long double s = static_cast<long double>(tour.positionOf(tour.twinOf(a)) - p + 1) / 2;
+                    sum += static_cast<long double>(tour.weightOf(a)) * s * (vertices - s);
+                    negative |= tour.weightOf(a) < 0;
+                }
+            });
+            chunkSum[k] = sum;
+            chunkNegative[k] = negative;
+        }
+    }, 1);
+
+    long double sum = 0;
+    bool negative = false;
+    for (size_t k = 0; k < chunks; ++k) {
+        sum += chunkSum[k];
+        negative |= chunkNegative[k];
+    }
+    long double pairs = 0;
+    for (int c = 0; c < numTrees; ++c) {
+        long double vertices = static_cast<long double>(starts[c + 1] - starts[c]) / 2 + 1;
+        pairs += vertices * (vertices - 1) / 2;
+    }
+
+    TreeMetrics metrics;
+    metrics.average = pairs > 0 ? static_cast<double>(sum / pairs) : 0.0;
+
+    if (!negative) {
+        // A chunk summarizes the tree it starts in and the tree it ends in, which may continue
+        // into neighbouring chunks, and keeps the best of the trees lying wholly inside it. Every
+        // tour is prefixed by its root at depth 0.
+        struct ChunkSummary {
+            int firstTree, lastTree;
+            PathSummary first, last;
+            int64_t inner;
+        };
+        ChunkSummary* summary = arena.allocate<ChunkSummary>(chunks);
+        pool.parallelFor(chunks, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                ChunkSummary& out = summary[k];
+                out.firstTree = -1;
+                out.inner = 0;
+                size_t from = std::min(numArcs, k * chunkSize), to = std::min(numArcs, (k + 1) * chunkSize);
+                forEachTreeRun(starts, numTrees, from, to, [&](int c, size_t runFrom, size_t runTo) {
+                    bool atStart = runFrom == starts[c];
+                    PathSummary s = PathSummary::of(atStart ? 0 : tour.depthAt(runFrom));
+                    for (size_t p = atStart ? runFrom : runFrom + 1; p < runTo; ++p) {
+                        s = s.then(PathSummary::of(tour.depthAt(p)));
+                    }
+                    if (out.firstTree == -1) {
+                        out.firstTree = c;
+                        out.first = s;
+                    } else if (out.lastTree != out.firstTree) {
+                        out.inner = std::max(out.inner, out.last.best);
+                    }
+                    out.lastTree = c;
+                    out.last = s;
+                });
+            }
+        }, 1);
+
+        int tree = -1;
+        PathSummary current = PathSummary::of(0);
+        for (size_t k = 0; k < chunks; ++k) {
+            const ChunkSummary& chunk = summary[k];
+            if (chunk.firstTree == -1) continue;
+            metrics.longest = std::max(metrics.longest, chunk.inner);
+            if (chunk.firstTree == tree) {
+                current = current.then(chunk.first);
+            } else {
+                if (tree != -1) metrics.longest = std::max(metrics.longest, current.best);
+                current = chunk.first;
+            }
+            tree = chunk.firstTree;
+            if (chunk.lastTree != chunk.firstTree) {
+                metrics.longest = std::max(metrics.longest, current.best);
+                tree = chunk.lastTree;
+                current = chunk.last;
+            }
+        }
+        if (tree != -1) metrics.longest = std::max(metrics.longest, current.best);
+        return metrics;
+    }
+
+    // Negative weights: longest path by DP, trees split across tasks. Leaving v upward means v's
+    // subtree is done, so its best downward path can be offered to its parent.
+    int n = tour.getNumVertices();
+    int64_t* down = arena.allocate<int64_t>(n);
+    std::fill(down, down + n, 0);
+    int64_t* treeLongest = arena.allocate<int64_t>(numTrees);
+    pool.parallelFor(numTrees, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            int64_t longest = 0;
+            for (size_t p = starts[c]; p < starts[c + 1]; ++p) {
+                if (tour.downAt(p)) continue;
+                int a = tour.arcAt(p);
+                int child = tour.headAt(tour.positionOf(tour.twinOf(a)));
+                int parent = tour.headAt(p);
+                int64_t candidate = down[child] + tour.weightOf(a);
+                longest = std::max(longest, down[parent] + candidate);
+                down[parent] = std::max(down[parent], candidate);
+            }
+            treeLongest[c] = longest;
+        }
+    });
+    for (int c = 0; c < numTrees; ++c) metrics.longest = std::max(metrics.longest, treeLongest[c]);
+    return metrics;
+}
@@ -0,0 +1,71 @@
+#ifndef EULER_TOUR_HPP
+#define EULER_TOUR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MST.hpp"
+
+class Arena;
+class ThreadPool;
+
+// Euler tour of a spanning forest, built in parallel.
+//
+// Every tree edge becomes two arcs. Each tree's tour starts at its lowest vertex, and the tours
+// are laid out one after another, so positions [componentStart[c], componentStart[c + 1]) hold
+// tree c. The tour order is found by list ranking over sublists, so each thread walks its own
+// pieces of the linked tour. Weighted depths then come from a parallel prefix sum over the tour.
+// Storage is kept across builds, so a workspace-owned tour is rebuilt without reallocating.
+class EulerTour {
+public:
+    void build(const MST& forest, Arena& arena, ThreadPool& pool);
+
+    int getNumVertices() const { return n; }
+    size_t size() const { return order.size(); }  // Arcs in the tour
+
+    // Arc visited at tour position p, and the vertex it enters
+    int arcAt(size_t p) const { return order[p]; }
+    int headAt(size_t p) const { return target[order[p]]; }
+    // Weighted depth of the vertex entered at position p, from its tree's root
+    int64_t depthAt(size_t p) const { return depth[p]; }
+    // True if the arc at position p goes away from the root
+    bool downAt(size_t p) const { return position[order[p]] < position[twin[order[p]]]; }
+    int weightOf(int arc) const { return weight[arc]; }
+    size_t positionOf(int arc) const { return position[arc]; }
+    int twinOf(int arc) const { return twin[arc]; }
+
+    // First position whose arc enters v, or -1 for a tree root (including isolated vertices)
+    int64_t firstVisit(int v) const { return first[v]; }
+    // Tree of v, numbered like componentStart
+    int componentOf(int v) const { return component[v]; }
+    int getNumComponents() const { return static_cast<int>(roots.size()); }
+    int rootOf(int c) const { return roots[c]; }
+    size_t componentStart(int c) const { return starts[c]; }
+
+private:
+    int n = 0;
+    std::vector<size_t> offsets;     // CSR over arcs: arcs of v are [offsets[v], offsets[v + 1])
+    std::vector<int> target;         // Head vertex of each arc
+    std::vector<int> weight;
+    std::vector<int> twin;           // The same edge in the other direction
+    std::vector<size_t> position;    // Tour position of each arc
+    std::vector<int> order;          // Arc at each tour position
+    std::vector<int64_t> depth;      // Weighted depth after each tour position
+    std::vector<int64_t> first;
+    std::vector<int> component;
+    std::vector<int> roots;
+    std::vector<size_t> starts;      // One entry per tree plus the end
+};
+
+// Distance metrics over every connected vertex pair of a forest
+struct TreeMetrics {
+    int64_t longest = 0;
+    double average = 0.0;
+};
+
+// O(n) work from the tour: pair distances summed edge by edge (w * s * (k - s) for a subtree of
+// s vertices in a tree of k), and the longest path as a parallel max-reduction over the depth
+// sequence. Negative weights break that reduction, so they fall back to a per-tree DP.
+TreeMetrics computeTreeMetrics(const EulerTour& tour, Arena& arena, ThreadPool& pool);
+
+#endif // EULER_TOUR_HPP
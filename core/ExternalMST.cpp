@@ -0,0 +1,332 @@
+#include "ExternalMST.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GraphFile.hpp"
+#include "GraphView.hpp"
+
+namespace {
+
+// Ties break on the endpoints as in the in-memory Kruskal, so both pick the same forest
+struct EdgeRecord {
+    int32_t weight;
+    int32_t u;
+    int32_t v;
+
+    bool operator<(const EdgeRecord& other) const {
+        return std::tie(weight, u, v) < std::tie(other.weight, other.u, other.v);
+    }
+};
+
+constexpr size_t IO_BLOCK = size_t(4) << 20;  // Preferred size of each run read and write
+constexpr size_t MAX_FAN_IN = 256;
+
+std::runtime_error ioError(const char* call) {
+    return std::runtime_error(std::string("external sort: ") + call + ": " + std::strerror(errno));
+}
+
+// A sorted run on disk. The file is unlinked as soon as it exists, so runs never outlive the
+// solve, even if the server dies during it.
+class RunFile {
+public:
+    explicit RunFile(const std::string& dir) {
+        std::string pattern = dir + "/mst-run-XXXXXX";
+        fd = mkostemp(pattern.data(), O_CLOEXEC);
+        if (fd == -1) throw ioError("mkostemp");
+        unlink(pattern.c_str());
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    ~RunFile() {
+        close(fd);
+    }
+
+    RunFile(const RunFile&) = delete;
+    RunFile& operator=(const RunFile&) = delete;
+
+    void append(const EdgeRecord* records, size_t count) {
+        const char* p = reinterpret_cast<const char*>(records);
+        size_t left = count * sizeof(EdgeRecord);
+        while (left > 0) {
+            ssize_t n = write(fd, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw ioError("write");
+            }
+            p += n;
+            left -= n;
+        }
+        size += count;
+    }
+
+    // Reads records [first, first + count) of the run
+    void read(EdgeRecord* records, uint64_t first, size_t count) const {
+        char* p = reinterpret_cast<char*>(records);
+        size_t left = count * sizeof(EdgeRecord);
+        off_t offset = static_cast<off_t>(first * sizeof(EdgeRecord));
+        while (left > 0) {
+            ssize_t n = pread(fd, p, left, offset);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw ioError("pread");
+            }
+            if (n == 0) {
+                errno = EIO;
+                throw ioError("pread");
+            }
+            p += n;
+            left -= n;
+            offset += n;
+        }
+    }
+
+    uint64_t records() const { return size; }
+
+private:
+    int fd;
+    uint64_t size = 0;
+};
+
+using Runs = std::vector<std::unique_ptr<RunFile>>;
+
+// Walks one run through its own block of the budget
+class RunReader {
+public:
+    RunReader(const RunFile& file, EdgeRecord* block, size_t capacity)
+        : file(file), block(block), capacity(capacity), offset(0), pos(0), len(0) {}
+
+    bool next(EdgeRecord& record) {
+        if (pos == len) {
+            if (offset == file.records()) return false;
+            len = static_cast<size_t>(std::min<uint64_t>(capacity, file.records() - offset));
+            file.read(block, offset, len);
+            offset += len;
+            pos = 0;
+        }
+        record = block[pos++];
+        return true;
+    }
+
+private:
+    const RunFile& file;
+    EdgeRecord* block;
+    size_t capacity;
+    uint64_t offset;  // Next record to read from the file
+    size_t pos;
+    size_t len;
+};
+
+// Feeds runs[first .. first + count) to sink in record order until sink returns false. `memory`
+// holds one block of blockRecords per run.
+template <typename Sink>
+void mergeRuns(const Runs& runs, size_t first, size_t count, EdgeRecord* memory, size_t blockRecords, Sink&& sink) {
+    std::vector<RunReader> readers;
+    readers.reserve(count);
+    for (size_t i = 0; i < count; ++i) readers.emplace_back(*runs[first + i], memory + i * blockRecords, blockRecords);
+
+    using Head = std::pair<EdgeRecord, size_t>;
+    auto later = [](const Head& a, const Head& b) { return b.first < a.first; };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heap(later);
+    for (size_t i = 0; i < count; ++i) {
+        EdgeRecord record;
+        if (readers[i].next(record)) heap.push({record, i});
+    }
+    while (!heap.empty()) {
+        Head head = heap.top();
+        heap.pop();
+        if (!sink(head.first)) return;
+        if (readers[head.second].next(head.first)) heap.push(head);
+    }
+}
+
+// Collects edges in memory up to the budget, spilling each full buffer as a sorted run
+class ExternalSorter {
+public:
+    ExternalSorter(const std::string& dir, size_t budget, uint64_t expectedEdges)
+        : dir(dir), budget(budget), capacity(std::max<size_t>(1, budget / sizeof(EdgeRecord))) {
+        buffer.reserve(static_cast<size_t>(std::min<uint64_t>(capacity, expectedEdges)));
+    }
+
+    void add(const EdgeRecord& record) {
+        if (buffer.size() == capacity) spill();
+        buffer.push_back(record);
+    }
+
+    // Hands every edge to sink in sorted order until sink returns false
+    template <typename Sink>
+    void finish(Sink&& sink) {
+        if (runs.empty()) {
+            std::sort(buffer.begin(), buffer.end());
+            for (const EdgeRecord& record : buffer) {
+                if (!sink(record)) return;
+            }
+            return;
+        }
+        spill();
+        std::vector<EdgeRecord>().swap(buffer);
+
+        // One input block per run and one output block, all inside the budget
+        size_t fanIn = std::clamp<size_t>(budget / IO_BLOCK, 3, MAX_FAN_IN + 1) - 1;
+        size_t blockRecords = std::max<size_t>(1, budget / (fanIn + 1) / sizeof(EdgeRecord));
+        std::unique_ptr<EdgeRecord[]> memory(new EdgeRecord[blockRecords * (fanIn + 1)]);
+
+        while (runs.size() > fanIn) {
+            Runs merged;
+            for (size_t first = 0; first < runs.size(); first += fanIn) {
+                size_t count = std::min(fanIn, runs.size() - first);
+                if (count == 1) {
+                    merged.push_back(std::move(runs[first]));
+                    continue;
+                }
+                auto out = std::make_unique<RunFile>(dir);
+                EdgeRecord* outBlock = memory.get() + fanIn * blockRecords;
+                size_t filled = 0;
+                mergeRuns(runs, first, count, memory.get(), blockRecords, [&](const EdgeRecord& record) {
+                    outBlock[filled++] = record;
+                    if (filled == blockRecords) {
+                        out->append(outBlock, filled);
+                        filled = 0;
+                    }
+                    return true;
+                });
+                out->append(outBlock, filled);
+                merged.push_back(std::move(out));
+                for (size_t i = 0; i < count; ++i) runs[first + i].reset();
+            }
+            runs.swap(merged);
+        }
+        mergeRuns(runs, 0, runs.size(), memory.get(), blockRecords, sink);
+    }
+
+private:
+    void spill() {
+        if (buffer.empty()) return;
+        std::sort(buffer.begin(), buffer.end());
+        auto run = std::make_unique<RunFile>(dir);
+        for (size_t k = 0; k < buffer.size(); k += IO_BLOCK / sizeof(EdgeRecord)) {
+            run->append(buffer.data() + k, std::min(IO_BLOCK / sizeof(EdgeRecord), buffer.size() - k));
+        }
+        runs.push_back(std::move(run));
+        buffer.clear();
+    }
+
+    std::string dir;
+    size_t budget;
+    size_t capacity;  // Records held in memory before a spill
+    std::vector<EdgeRecord> buffer;
+    Runs runs;
+};
+
+// Union-find over the sorted edge stream; stops the stream once the forest spans the graph
+class ForestBuilder {
+public:
+    ForestBuilder(int n, MST& forest) : parent(n), rank(n, 0), forest(forest), missing(n > 0 ? n - 1 : 0) {
+        for (int i = 0; i < n; ++i) parent[i] = i;
+        forest.reset(n);
+    }
+
+    bool add(const EdgeRecord& edge) {
+        int a = find(edge.u);
+        int b = find(edge.v);
+        if (a == b) return true;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) ++rank[a];
+        forest.addEdge(edge.u, edge.v, edge.weight);
+        return --missing > 0;
+    }
+
+    // One summary per tree, in order of lowest vertex
+    void finish() {
+        int n = static_cast<int>(parent.size());
+        std::vector<int> index(n, -1);
+        std::vector<ComponentStats> components;
+        for (int v = 0; v < n; ++v) {
+            int root = find(v);
+            if (index[root] < 0) {
+                index[root] = static_cast<int>(components.size());
+                components.push_back({v, 0, 0});
+            }
+            ++components[index[root]].vertices;
+        }
+        for (const MSTEdge& edge : forest.getEdges()) components[index[find(edge.from)]].totalWeight += edge.weight;
+        for (const ComponentStats& component : components) forest.addComponent(component);
+    }
+
+private:
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    std::vector<int> parent;
+    std::vector<uint8_t> rank;
+    MST& forest;
+    int missing;  // Edges the forest still needs to be a spanning tree
+};
+
+} // namespace
+
+bool ExternalMST::configure(const std::string& dir, size_t budget) {
+    struct stat st;
+    if (stat(dir.c_str(), &st) == -1 || !S_ISDIR(st.st_mode) || access(dir.c_str(), W_OK | X_OK) == -1) return false;
+    if (budget < MIN_BUDGET) return false;
+    scratchDir = dir;
+    memoryBudget = budget;
+    return true;
+}
+
+void ExternalMST::solve(const Graph& graph, MST& forest) const {
+    int n = graph.getNumVertices();
+    ExternalSorter sorter(scratchDir, memoryBudget, graph.getNumEdges());
+    graph.visitEdges([&sorter](const auto& edges) {
+        edges.forEachEdge([&sorter](int u, int v, int w) { sorter.add({w, u, v}); });
+    });
+    ForestBuilder builder(n, forest);
+    if (n > 1) sorter.finish([&builder](const EdgeRecord& edge) { return builder.add(edge); });
+    builder.finish();
+}
+
+bool ExternalMST::solveFile(const std::string& path, MST& forest) const {
+    MappedGraphFile file;
+    if (!file.open(path)) return false;
+    int n = static_cast<int>(file.getNumVertices());
+    const uint64_t* offsets = file.offsets();
+    const int32_t* targets = file.targets();
+    const int32_t* weights = file.weights();
+
+    ExternalSorter sorter(scratchDir, memoryBudget, file.getNumEdges());
+    for (int u = 0; u < n; ++u) {
+        if (offsets[u + 1] < offsets[u] || offsets[u + 1] > file.getNumEdges()) {
+            std::cerr << "RunMSTFile: " << path << " has corrupt offsets\n";
+            return false;
+        }
+        for (uint64_t k = offsets[u]; k < offsets[u + 1]; ++k) {
+            int v = targets[k];
+            if (v < 0 || v >= n) {
+                std::cerr << "RunMSTFile: " << path << " names vertex " << v << " of " << n << "\n";
+                return false;
+            }
+            sorter.add({weights[k], std::min(u, v), std::max(u, v)});
+        }
+    }
+    ForestBuilder builder(n, forest);
+    if (n > 1) sorter.finish([&builder](const EdgeRecord& edge) { return builder.add(edge); });
+    builder.finish();
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef EXTERNAL_MST_HPP
+#define EXTERNAL_MST_HPP
+
+#include <cstddef>
+#include <string>
+#include "Graph.hpp"
+#include "MST.hpp"
+
+// Kruskal for graphs whose edges do not fit in memory. Edges are gathered into sorted runs of at
+// most the memory budget, spilled to unlinked files in the scratch directory, and merged back in
+// as few passes as the budget's fan-in allows; the last pass streams straight into union-find.
+// Only the union-find arrays (9 bytes a vertex) and the forest itself live outside the budget.
+// A graph whose edges fit in one run is never written out.
+class ExternalMST {
+public:
+    static constexpr const char* NAME = "External";  // RunMST algorithm name for this solver
+    static constexpr size_t DEFAULT_BUDGET = size_t(256) << 20;
+    static constexpr size_t MIN_BUDGET = size_t(1) << 20;
+
+    // Checks that the directory is writable and the budget holds at least MIN_BUDGET
+    bool configure(const std::string& scratchDir, size_t memoryBudget);
+
+    // Minimum spanning forest of an in-memory graph, without the in-memory solvers' edge copies.
+    // Throws std::runtime_error if the scratch files cannot be written or read.
+    void solve(const Graph& graph, MST& forest) const;
+    // Same for a graph file in the LoadGraph layout, read in place instead of loaded. Returns
+    // false if the file cannot be opened or names a vertex out of range.
+    bool solveFile(const std::string& path, MST& forest) const;
+
+    const std::string& getScratchDir() const { return scratchDir; }
+    size_t getMemoryBudget() const { return memoryBudget; }
+
+    // Settings used by RunMST External and RunMSTFile; replaced at startup by --scratch-dir and
+    // --em-budget-mb
+    static ExternalMST& active() {
+        static ExternalMST instance;
+        return instance;
+    }
+
+private:
+    std::string scratchDir = "/tmp";
+    size_t memoryBudget = DEFAULT_BUDGET;
+};
+
+#endif // EXTERNAL_MST_HPP
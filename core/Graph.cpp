@@ -0,0 +1,339 @@
+#include "Graph.hpp"
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <iterator>
+
+Graph::Graph() : n(0), m(0), version(0) {}
+
+void Graph::NewGraph(int n, int m) {
+    this->n = n;
+    this->m = m;
+    this->adj.assign(n, std::vector<std::pair<int, int>>());
+    edgeIndex.clear();
+    edgeIndex.reserve(m);
+    ingestStats = IngestStats();
+    shapeStats = ShapeStats();
+    ++version;
+}
+
+// Upsert: an existing edge between i and j, in either direction, gets the new weight instead of
+// a parallel copy
+void Graph::NewEdge(int i, int j, int weight) {
+    if (i > n || j > n) return;
+    materialize();
+    ++ingestStats.received;
+    if (i == j) {
+        ++ingestStats.selfLoopsDropped;
+        return;
+    }
+    int u = std::min(i, j) - 1, v = std::max(i, j) - 1;
+    auto& edges = adj[u];
+    uint32_t position = edgeIndex.find(u, v);
+    if (position != EdgeIndex::NOT_FOUND) {
+        ++ingestStats.weightsReplaced;
+        edges[position].second = weight;
+    } else {
+        edgeIndex.assign(u, v, static_cast<uint32_t>(edges.size()));
+        edges.push_back({v, weight});
+    }
+    noteEdge(u, weight);
+    ++version;
+}
+
+// O(1): the last edge of the list moves into the removed edge's place. Either direction names
+// the same edge.
+void Graph::RemoveEdge(int i, int j) {
+    materialize();
+    int u = std::min(i, j) - 1, v = std::max(i, j) - 1;
+    auto& edges = adj[u];
+    uint32_t position = edgeIndex.find(u, v);
+    if (position == EdgeIndex::NOT_FOUND) return;
+    edgeIndex.erase(u, v);
+    if (position != edges.size() - 1) {
+        edges[position] = edges.back();
+        edgeIndex.assign(u, edges[position].first, position);
+    }
+    edges.pop_back();
+    ++version;
+}
+
+// The file stays mapped and the solvers read its arrays in place, so a load is one sequential
+// validating pass instead of a hash insert per edge. The lists and edge index are built only when
+// a mutation first needs them. That needs every edge stored once, in the row of its lower
+// endpoint, as SaveGraph writes them; a file with an edge stored from its higher endpoint, a
+// repeat within a row or a self-loop is ingested straight away instead, so parallel edges
+// collapse and self-loops drop as for any other input.
+bool Graph::LoadGraph(const std::string& path) {
+    auto file = std::make_shared<MappedGraphFile>();
+    if (!file->open(path)) return false;
+
+    int fileN = static_cast<int>(file->getNumVertices());
+    uint64_t fileM = file->getNumEdges();
+    const uint64_t* offsets = file->offsets();
+    const int32_t* targets = file->targets();
+    const int32_t* weights = file->weights();
+
+    // Checked into a fresh graph so a corrupt file leaves the current one untouched
+    Graph loaded;
+    bool reduce = false;
+    std::vector<int> lastRow(fileN, -1);  // Row that last listed each target, to spot repeats
+    for (int i = 0; i < fileN; ++i) {
+        uint64_t begin = offsets[i], end = offsets[i + 1];
+        if (end < begin || end > fileM) return false;
+        for (uint64_t k = begin; k < end; ++k) {
+            if (targets[k] < 0 || targets[k] >= fileN) return false;
+            reduce |= targets[k] <= i || lastRow[targets[k]] == i;
+            lastRow[targets[k]] = i;
+            ShapeStats& shape = loaded.shapeStats;
+            shape.minWeight = shape.hasEdges ? std::min(shape.minWeight, weights[k]) : weights[k];
+            shape.maxWeight = shape.hasEdges ? std::max(shape.maxWeight, weights[k]) : weights[k];
+            shape.hasEdges = true;
+        }
+        loaded.shapeStats.maxDegree = std::max<size_t>(loaded.shapeStats.maxDegree, end - begin);
+    }
+    loaded.n = fileN;
+    loaded.m = static_cast<int>(std::min<uint64_t>(fileM, INT_MAX));
+    loaded.ingestStats.received = fileM;
+    loaded.mapped = std::move(file);
+    if (reduce) loaded.materialize();
+
+    uint64_t next = version + 1;
+    *this = std::move(loaded);
+    version = next;
+    return true;
+}
+
+// Ingests a mapped graph's file into adj and edgeIndex and lets the mapping go. The edge set does
+// not change, so neither does the version.
+void Graph::materialize() {
+    if (!mapped) return;
+    const uint64_t* offsets = mapped->offsets();
+    const int32_t* targets = mapped->targets();
+    const int32_t* weights = mapped->weights();
+
+    // Built aside, so a failed allocation leaves the graph mapped and whole
+    Graph built;
+    built.NewGraph(n, m);
+    for (int i = 0; i < n; ++i) {
+        for (uint64_t k = offsets[i]; k < offsets[i + 1]; ++k) built.ingestEdge(i, targets[k], weights[k]);
+    }
+    built.version = version;
+    *this = std::move(built);
+}
+
+// Generated edges go through the same ingest as a loaded file, in generation order, so repeats
+// collapse the same way every time
+bool Graph::GenerateGraph(const GraphGenerator::Spec& spec) {
+    std::vector<GraphGenerator::Edge> edges;
+    if (!GraphGenerator::generate(spec, edges)) return false;
+
+    Graph generated;
+    generated.NewGraph(spec.n, static_cast<int>(std::min<size_t>(edges.size(), INT_MAX)));
+    for (const GraphGenerator::Edge& edge : edges) generated.ingestEdge(edge.u, edge.v, edge.weight);
+
+    uint64_t next = version + 1;
+    *this = std::move(generated);
+    version = next;
+    return true;
+}
+
+bool Graph::SaveGraph(const std::string& path, uint64_t sequence) const {
+    if (mapped) {
+        return writeGraphFile(path, n, mapped->offsets(), mapped->targets(), mapped->weights(), sequence);
+    }
+    return writeGraphFile(path, adj, sequence);
+}
+
+// Three flat arrays filled in one pass, so taking an image is far cheaper than copying the lists
+// and the edge index
+Graph::Image Graph::image() const {
+    Image image;
+    image.n = static_cast<uint64_t>(n);
+    if (mapped) {
+        image.mapped = mapped;
+        return image;
+    }
+    image.offsets.resize(image.n + 1);
+    image.offsets[0] = 0;
+    for (uint64_t i = 0; i < image.n; ++i) image.offsets[i + 1] = image.offsets[i] + adj[i].size();
+    image.targets.resize(image.offsets[image.n]);
+    image.weights.resize(image.offsets[image.n]);
+    for (uint64_t i = 0; i < image.n; ++i) {
+        uint64_t k = image.offsets[i];
+        for (const auto& edge : adj[i]) {
+            image.targets[k] = edge.first;
+            image.weights[k] = edge.second;
+            ++k;
+        }
+    }
+    return image;
+}
+
+bool Graph::Image::save(const std::string& path, uint64_t sequence) const {
+    if (mapped) {
+        return writeGraphFile(path, n, mapped->offsets(), mapped->targets(), mapped->weights(), sequence);
+    }
+    return writeGraphFile(path, n, offsets.data(), targets.data(), weights.data(), sequence);
+}
+
+std::vector<std::string> Graph::parse(std::string_view command) {
+    // Splits on whitespace in place, so a line framed out of a receive buffer is tokenized
+    // without first being copied into a string and a stream
+    std::vector<std::string> parts;
+    auto blank = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    size_t pos = 0;
+    while (pos < command.size()) {
+        while (pos < command.size() && blank(command[pos])) ++pos;
+        size_t begin = pos;
+        while (pos < command.size() && !blank(command[pos])) ++pos;
+        if (pos > begin) parts.emplace_back(command.substr(begin, pos - begin));
+    }
+
+    // NewGraph and Batch keep one token per edge/item and GenerateGraph its positional arguments;
+    // their arguments are split later
+    if (parts.size() > 1 && parts[0] != "NewGraph" && parts[0] != "Batch" && parts[0] != "GenerateGraph") {
+        std::string joined = std::move(parts[1]);
+        std::vector<std::string> args;
+        size_t start = 0;
+        while (start < joined.size()) {
+            size_t comma = joined.find(',', start);
+            if (comma == std::string::npos) comma = joined.size();
+            args.push_back(joined.substr(start, comma - start));
+            start = comma + 1;
+        }
+        parts.erase(parts.begin() + 1);
+        parts.insert(parts.end(), std::make_move_iterator(args.begin()), std::make_move_iterator(args.end()));
+    }
+
+    return parts;
+}
+
+bool Graph::eval(const std::vector<std::string>& parts) {
+    if (parts.empty()) return true;
+
+    const std::string& cmd = parts[0];
+
+    if (cmd == "NewGraph") {
+        if (parts.size() < 3) return false;
+        int n = std::stoi(parts[1]);
+        int m = std::stoi(parts[2]);
+        if (n < 1 || m < 1) return false;
+        // Built aside and swapped in, so a bad edge or a failed allocation keeps the old graph.
+        // The edge index is sized for the edges actually sent, not the declared m, so a short line
+        // cannot make it reserve gigabytes; NewEdge grows it on demand.
+        Graph created;
+        created.NewGraph(n, static_cast<int>(std::min<size_t>(m, parts.size() - 3)));
+        if (!created.evalEdges(parts)) return false;
+        uint64_t next = version + 1;
+        *this = std::move(created);
+        version = next;
+        return true;
+    } else if (cmd == "NewEdge") {
+        if (parts.size() != 4) return false;
+        int i = std::stoi(parts[1]);
+        int j = std::stoi(parts[2]);
+        int weight = std::stoi(parts[3]);
+        if (i > n || i < 1 || j > n || j < 1) return false;
+        NewEdge(i, j, weight);
+    } else if (cmd == "RemoveEdge") {
+        if (parts.size() != 3) return false;
+        int i = std::stoi(parts[1]);
+        int j = std::stoi(parts[2]);
+        if (i > n || i < 1 || j > n || j < 1) return false;
+        RemoveEdge(i, j);
+    } else if (cmd == "Batch") {
+        std::vector<size_t> failedItems;
+        return evalBatch(parts, failedItems);
+    } else if (cmd == "LoadGraph") {
+        std::string path;
+        if (parts.size() != 2 || !DataDirectory::active().resolve(parts[1], path)) return false;
+        return LoadGraph(path);
+    } else if (cmd == "GenerateGraph") {
+        GraphGenerator::Spec spec;
+        if (!GraphGenerator::parse(parts, spec)) return false;
+        return GenerateGraph(spec);
+    } else if (cmd == "SaveGraph") {
+        std::string path;
+        if (parts.size() != 2 || !DataDirectory::active().resolve(parts[1], path)) return false;
+        return SaveGraph(path);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool Graph::evalEdges(const std::vector<std::string>& parts) {
+    for (size_t i = 3; i < parts.size(); ++i) {
+        std::istringstream iss_edge(parts[i]);
+        std::string edge;
+        std::getline(iss_edge, edge, ',');
+        int from = std::stoi(edge);
+        std::getline(iss_edge, edge, ',');
+        int to = std::stoi(edge);
+        std::getline(iss_edge, edge, ',');
+        int weight = std::stoi(edge);
+        if (from > n || from < 1 || to > n || to < 1) return false;
+        ingestEdge(from - 1, to - 1, weight);
+    }
+    return true;
+}
+
+// Bulk ingest (NewGraph edge lists, loaded files): only the lightest of parallel edges can be in
+// an MST, so duplicates in either direction collapse to their minimum weight and self-loops are
+// dropped. Edges are undirected, so each is stored once, in the list of its lower endpoint.
+void Graph::ingestEdge(int u, int v, int weight) {
+    ++ingestStats.received;
+    if (u == v) {
+        ++ingestStats.selfLoopsDropped;
+        return;
+    }
+    if (u > v) std::swap(u, v);
+    auto& edges = adj[u];
+    uint32_t position = edgeIndex.find(u, v);
+    if (position != EdgeIndex::NOT_FOUND) {
+        ++ingestStats.parallelCollapsed;
+        edges[position].second = std::min(edges[position].second, weight);
+    } else {
+        edgeIndex.assign(u, v, static_cast<uint32_t>(edges.size()));
+        edges.push_back({v, weight});
+    }
+    noteEdge(u, weight);
+    ++version;
+}
+
+void Graph::noteEdge(int u, int weight) {
+    shapeStats.minWeight = shapeStats.hasEdges ? std::min(shapeStats.minWeight, weight) : weight;
+    shapeStats.maxWeight = shapeStats.hasEdges ? std::max(shapeStats.maxWeight, weight) : weight;
+    shapeStats.hasEdges = true;
+    shapeStats.maxDegree = std::max(shapeStats.maxDegree, adj[u].size());
+}
+
+// Batch NewEdge i,j,w RemoveEdge i,j ...
+// Items are applied in order; an invalid item is skipped and its 1-based index reported, the rest
+// still apply. Returns false only if the batch itself is malformed, in which case nothing is applied.
+bool Graph::evalBatch(const std::vector<std::string>& parts, std::vector<size_t>& failedItems) {
+    if (parts.size() < 3 || (parts.size() - 1) % 2 != 0) return false;
+    for (size_t i = 1; i < parts.size(); i += 2) {
+        if (parts[i] != "NewEdge" && parts[i] != "RemoveEdge") return false;
+    }
+
+    for (size_t i = 1; i < parts.size(); i += 2) {
+        std::vector<std::string> item{parts[i]};
+        std::istringstream iss(parts[i + 1]);
+        std::string arg;
+        while (std::getline(iss, arg, ',')) {
+            item.push_back(arg);
+        }
+        bool ok;
+        try {
+            ok = eval(item);
+        } catch (const std::exception&) {
+            ok = false;
+        }
+        if (!ok) failedItems.push_back((i + 1) / 2);
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <string_view>
+#include "EdgeIndex.hpp"
+#include "GraphFile.hpp"
+#include "GraphGenerator.hpp"
+#include "GraphView.hpp"
+
+class Graph {
+public:
+    // Edges reduced away while building the current graph, reset by NewGraph and LoadGraph
+    struct IngestStats {
+        uint64_t received = 0;          // Edges offered by NewGraph, NewEdge or a loaded file
+        uint64_t parallelCollapsed = 0; // Duplicates of an already stored edge, in either direction
+        uint64_t weightsReplaced = 0;   // NewEdge on a stored edge, which takes the new weight
+        uint64_t selfLoopsDropped = 0;  // Edges i -> i, which no spanning tree can use
+    };
+
+    // Running shape of the graph for algorithm selection. The weight range and maximum degree
+    // only widen until the next NewGraph or LoadGraph, so after removals they are upper bounds.
+    struct ShapeStats {
+        bool hasEdges = false;
+        int minWeight = 0;
+        int maxWeight = 0;
+        size_t maxDegree = 0;
+    };
+
+    // The edges in graph file layout, detached from the graph so they can be written after its
+    // lock is released: the mapped file itself, or the lists flattened into the file's arrays
+    class Image {
+    public:
+        bool save(const std::string& path, uint64_t sequence) const;
+
+    private:
+        friend class Graph;
+        uint64_t n = 0;
+        std::shared_ptr<const MappedGraphFile> mapped;
+        std::vector<uint64_t> offsets;
+        std::vector<int32_t> targets;
+        std::vector<int32_t> weights;
+    };
+
+    Graph();
+    void NewGraph(int n, int m);
+    void NewEdge(int i, int j, int weight);
+    void RemoveEdge(int i, int j);
+    bool LoadGraph(const std::string& path);
+    bool SaveGraph(const std::string& path, uint64_t sequence = 0) const;
+    bool GenerateGraph(const GraphGenerator::Spec& spec);
+    Image image() const;
+    std::vector<std::string> parse(std::string_view command);
+    bool eval(const std::vector<std::string>& parts);
+    bool evalBatch(const std::vector<std::string>& parts, std::vector<size_t>& failedItems);
+
+    int getNumVertices() const { return n; }
+    size_t getNumEdges() const { return mapped ? mapped->getNumEdges() : edgeIndex.size(); }
+    const IngestStats& getIngestStats() const { return ingestStats; }
+    const ShapeStats& getShapeStats() const { return shapeStats; }
+    // Changes whenever the edge set may have changed, so results derived from the graph can be cached
+    uint64_t getVersion() const { return version; }
+
+    // Calls f with the storage policy holding the edges: an AdjacencyView of the lists, or a
+    // MappedView of the loaded file while the graph is still read in place
+    template <typename F>
+    void visitEdges(F&& f) const {
+        if (mapped) {
+            f(MappedView(n, mapped->offsets(), mapped->targets(), mapped->weights()));
+        } else {
+            f(AdjacencyView(adj));
+        }
+    }
+
+private:
+    int n; // Number of vertices
+    int m; // Number of arcs
+    std::vector<std::vector<std::pair<int, int>>> adj; // Adjacency list (vertex, weight)
+    EdgeIndex edgeIndex; // (i, j), i < j -> position in adj[i], so each undirected edge is stored once
+    // The file of the last LoadGraph, while no mutation has needed adj and edgeIndex built; the
+    // lists are empty meanwhile. Shared so copies of the graph keep the mapping alive.
+    std::shared_ptr<const MappedGraphFile> mapped;
+    IngestStats ingestStats;
+    ShapeStats shapeStats;
+    uint64_t version;
+    bool evalEdges(const std::vector<std::string>& parts);
+    void ingestEdge(int u, int v, int weight);
+    void noteEdge(int u, int weight);
+    void materialize();
+};
+
+#endif // GRAPH_HPP
\ No newline at end of file
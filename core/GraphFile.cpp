@@ -0,0 +1,178 @@
+#include "GraphFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char GRAPH_FILE_MAGIC[8] = {'M', 'S', 'T', 'G', 'R', 'A', 'P', 'H'};
+
+MappedGraphFile::~MappedGraphFile() {
+    close();
+}
+
+bool MappedGraphFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        perror("open");
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(GraphFileHeader)) {
+        std::cerr << "LoadGraph: " << path << " is not a graph file\n";
+        ::close(fd);
+        return false;
+    }
+
+    // MAP_SHARED keeps the pages in the page cache, so concurrent loaders share them
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    base = p;
+    length = st.st_size;
+
+    if (!validate()) {
+        std::cerr << "LoadGraph: " << path << " has an invalid header\n";
+        close();
+        return false;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+    madvise(base, length, MADV_WILLNEED);
+    return true;
+}
+
+void MappedGraphFile::close() {
+    if (base != nullptr) {
+        munmap(base, length);
+        base = nullptr;
+        length = 0;
+    }
+}
+
+bool MappedGraphFile::validate() const {
+    const GraphFileHeader* h = header();
+    if (std::memcmp(h->magic, GRAPH_FILE_MAGIC, sizeof h->magic) != 0) return false;
+    if (h->version != VERSION || h->headerSize != sizeof(GraphFileHeader)) return false;
+    if (h->fileSize != length) return false;
+    if (h->numVertices > static_cast<uint64_t>(INT32_MAX)) return false;
+
+    uint64_t n = h->numVertices, m = h->numEdges;
+    if (m > length) return false;
+    if (h->offsetsOffset % ALIGNMENT || h->targetsOffset % ALIGNMENT || h->weightsOffset % ALIGNMENT) return false;
+    // Compared as offset <= length and size <= length - offset, so a hostile offset cannot wrap
+    auto fits = [this](uint64_t offset, uint64_t size) { return offset <= length && size <= length - offset; };
+    if (!fits(h->offsetsOffset, (n + 1) * sizeof(uint64_t))) return false;
+    if (!fits(h->targetsOffset, m * sizeof(int32_t))) return false;
+    if (!fits(h->weightsOffset, m * sizeof(int32_t))) return false;
+
+    const uint64_t* off = offsets();
+    if (off[0] != 0 || off[n] != m) return false;
+    return true;
+}
+
+bool DataDirectory::configure(const std::string& dir) {
+    struct stat st;
+    if (stat(dir.c_str(), &st) == -1 || !S_ISDIR(st.st_mode)) return false;
+    directory = dir;
+    return true;
+}
+
+bool DataDirectory::resolve(const std::string& name, std::string& path) const {
+    if (name.empty() || name[0] == '/') return false;
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t slash = std::min(name.find('/', start), name.size());
+        if (name.compare(start, slash - start, "..") == 0) return false;
+        start = slash + 1;
+    }
+    path = directory + "/" + name;
+    return true;
+}
+
+static bool writeAt(int fd, const void* data, size_t size, uint64_t offset) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, p, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            perror("pwrite");
+            return false;
+        }
+        p += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+bool writeGraphFile(const std::string& path,
+                    const std::vector<std::vector<std::pair<int, int>>>& adj,
+                    uint64_t sequence) {
+    uint64_t n = adj.size();
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint64_t i = 0; i < n; ++i) {
+        offsets[i + 1] = offsets[i] + adj[i].size();
+    }
+    uint64_t m = offsets[n];
+
+    std::vector<int32_t> targets(m), weights(m);
+    for (uint64_t i = 0; i < n; ++i) {
+        uint64_t k = offsets[i];
+        for (const auto& edge : adj[i]) {
+            targets[k] = edge.first;
+            weights[k] = edge.second;
+            ++k;
+        }
+    }
+    return writeGraphFile(path, n, offsets.data(), targets.data(), weights.data(), sequence);
+}
+
+bool writeGraphFile(const std::string& path, uint64_t n, const uint64_t* offsets,
+                    const int32_t* targets, const int32_t* weights, uint64_t sequence) {
+    uint64_t m = offsets[n];
+    GraphFileHeader h{};
+    std::memcpy(h.magic, GRAPH_FILE_MAGIC, sizeof h.magic);
+    h.version = MappedGraphFile::VERSION;
+    h.headerSize = sizeof(GraphFileHeader);
+    h.numVertices = n;
+    h.numEdges = m;
+    h.sequence = sequence;
+    h.offsetsOffset = MappedGraphFile::alignUp(sizeof h);
+    h.targetsOffset = MappedGraphFile::alignUp(h.offsetsOffset + (n + 1) * sizeof(uint64_t));
+    h.weightsOffset = MappedGraphFile::alignUp(h.targetsOffset + m * sizeof(int32_t));
+    h.fileSize = h.weightsOffset + m * sizeof(int32_t);
+
+    // Write next to the destination and rename, so readers never map a half-written file
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        perror("open");
+        return false;
+    }
+
+    bool ok = ftruncate(fd, h.fileSize) == 0 &&
+              writeAt(fd, &h, sizeof h, 0) &&
+              writeAt(fd, offsets, (n + 1) * sizeof(uint64_t), h.offsetsOffset) &&
+              writeAt(fd, targets, m * sizeof(int32_t), h.targetsOffset) &&
+              writeAt(fd, weights, m * sizeof(int32_t), h.weightsOffset) &&
+              fdatasync(fd) == 0;
+    ::close(fd);
+
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        perror("SaveGraph");
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
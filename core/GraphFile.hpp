@@ -0,0 +1,90 @@
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// On-disk graph layout (version 1, native endianness):
+//   [header][pad to page] [offsets: (n+1) x uint64][pad] [targets: m x int32][pad] [weights: m x int32]
+// Every section starts on a 4 KiB boundary so the file can be mmap'ed and read in place.
+struct GraphFileHeader {
+    char magic[8];           // "MSTGRAPH"
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t numVertices;
+    uint64_t numEdges;
+    uint64_t sequence;       // Last logged mutation folded into this file (0 if none)
+    uint64_t offsetsOffset;  // CSR row offsets, (n+1) entries
+    uint64_t targetsOffset;  // Edge targets, 0-based vertex ids
+    uint64_t weightsOffset;  // Edge weights, parallel to targets
+    uint64_t fileSize;
+};
+
+class MappedGraphFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t ALIGNMENT = 4096;
+
+    MappedGraphFile() = default;
+    ~MappedGraphFile();
+    MappedGraphFile(const MappedGraphFile&) = delete;
+    MappedGraphFile& operator=(const MappedGraphFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    uint64_t getNumVertices() const { return header()->numVertices; }
+    uint64_t getNumEdges() const { return header()->numEdges; }
+    uint64_t getSequence() const { return header()->sequence; }
+    const uint64_t* offsets() const { return at<uint64_t>(header()->offsetsOffset); }
+    const int32_t* targets() const { return at<int32_t>(header()->targetsOffset); }
+    const int32_t* weights() const { return at<int32_t>(header()->weightsOffset); }
+
+    static uint64_t alignUp(uint64_t x) { return (x + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+private:
+    const GraphFileHeader* header() const { return static_cast<const GraphFileHeader*>(base); }
+    template <typename T>
+    const T* at(uint64_t offset) const {
+        return reinterpret_cast<const T*>(static_cast<const char*>(base) + offset);
+    }
+    bool validate() const;
+
+    void* base = nullptr;
+    size_t length = 0;
+};
+
+// Where client-named graph files live (--data-dir). Names are taken relative to it; absolute
+// names and any ".." component are refused, so a client cannot reach files outside it. Symlinks
+// inside the directory are the operator's and are followed.
+class DataDirectory {
+public:
+    // False unless dir is an existing directory
+    bool configure(const std::string& dir);
+    // Path of a client-supplied name inside the directory, or false if the name would leave it
+    bool resolve(const std::string& name, std::string& path) const;
+
+    const std::string& getDirectory() const { return directory; }
+
+    static DataDirectory& active() {
+        static DataDirectory instance;
+        return instance;
+    }
+
+private:
+    std::string directory = ".";
+};
+
+// Serializes an adjacency list in the layout above; writes to "<path>.tmp" and renames over path
+bool writeGraphFile(const std::string& path,
+                    const std::vector<std::vector<std::pair<int, int>>>& adj,
+                    uint64_t sequence = 0);
+// Same from arrays already in the file layout, such as another mapped file's
+bool writeGraphFile(const std::string& path, uint64_t n, const uint64_t* offsets,
+                    const int32_t* targets, const int32_t* weights, uint64_t sequence = 0);
+
+#endif // GRAPH_FILE_HPP
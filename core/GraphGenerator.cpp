@@ -0,0 +1,268 @@
+#include "GraphGenerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include "ThreadPool.hpp"
+
+namespace {
+
+constexpr uint64_t BLOCK = uint64_t(1) << 16;  // Edges, or vertices for vertex-driven families, per block
+constexpr double POWER_LAW_EXPONENT = 2.5;
+
+const char* const FAMILIES[] = {"random", "grid", "complete", "powerlaw", "geometric"};
+
+// SplitMix64, one stream per block. Streams start at a hash of (seed, block), not a fixed step
+// apart, so neighbouring blocks do not replay each other's draws shifted by one.
+class Rng {
+public:
+    Rng(uint64_t seed, uint64_t block) : state(mix(seed ^ mix(block + GOLDEN))) {}
+
+    uint64_t next() {
+        return mix(state += GOLDEN);
+    }
+
+    // Uniform in [0, bound) for bound <= 2^32, by multiply-shift instead of a modulo
+    uint64_t below(uint64_t bound) { return ((next() >> 32) * bound) >> 32; }
+
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+private:
+    static constexpr uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state;
+};
+
+int randomWeight(Rng& rng, const GraphGenerator::Spec& spec) {
+    uint64_t span = static_cast<uint64_t>(int64_t(spec.maxWeight) - spec.minWeight) + 1;
+    return static_cast<int>(spec.minWeight + static_cast<int64_t>(rng.below(span)));
+}
+
+bool parseInteger(const std::string& text, long long lo, long long hi, long long& value) {
+    errno = 0;
+    char* end;
+    long long parsed = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno == ERANGE || parsed < lo || parsed > hi) return false;
+    value = parsed;
+    return true;
+}
+
+// Fills every block on the solver pool, then concatenates them in block order. False, with no
+// edges, once the blocks add up to more than MAX_EDGES.
+template <typename F>
+bool generateBlocks(uint64_t numBlocks, std::vector<GraphGenerator::Edge>& edges, F&& fill) {
+    ThreadPool& pool = ThreadPool::shared();
+    std::vector<std::vector<GraphGenerator::Edge>> blocks(numBlocks);
+    std::atomic<uint64_t> produced{0};
+    pool.parallelFor(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            if (produced.load(std::memory_order_relaxed) > GraphGenerator::MAX_EDGES) return;
+            fill(b, blocks[b]);
+            produced.fetch_add(blocks[b].size(), std::memory_order_relaxed);
+        }
+    }, 1);
+    if (produced.load() > GraphGenerator::MAX_EDGES) return false;
+
+    std::vector<size_t> offsets(numBlocks + 1, 0);
+    for (uint64_t b = 0; b < numBlocks; ++b) offsets[b + 1] = offsets[b] + blocks[b].size();
+    edges.resize(offsets[numBlocks]);
+    pool.parallelFor(numBlocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            std::copy(blocks[b].begin(), blocks[b].end(), edges.begin() + offsets[b]);
+            std::vector<GraphGenerator::Edge>().swap(blocks[b]);
+        }
+    }, 1);
+    return true;
+}
+
+uint64_t blocksFor(uint64_t items) {
+    return (items + BLOCK - 1) / BLOCK;
+}
+
+bool randomEdges(const GraphGenerator::Spec& spec, std::vector<GraphGenerator::Edge>& edges) {
+    return generateBlocks(blocksFor(spec.m), edges, [&spec](uint64_t b, std::vector<GraphGenerator::Edge>& out) {
+        Rng rng(spec.seed, b);
+        uint64_t count = std::min(BLOCK, spec.m - b * BLOCK);
+        out.reserve(count);
+        for (uint64_t k = 0; k < count; ++k) {
+            int u = static_cast<int>(rng.below(spec.n));
+            int v = static_cast<int>(rng.below(spec.n - 1));
+            if (v >= u) ++v;
+            out.push_back({u, v, randomWeight(rng, spec)});
+        }
+    });
+}
+
+bool gridEdges(const GraphGenerator::Spec& spec, std::vector<GraphGenerator::Edge>& edges) {
+    int64_t n = spec.n;
+    int64_t cols = static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+    while (cols * cols < n) ++cols;
+    return generateBlocks(blocksFor(n), edges, [&spec, n, cols](uint64_t b, std::vector<GraphGenerator::Edge>& out) {
+        Rng rng(spec.seed, b);
+        int64_t last = std::min<int64_t>(n, (b + 1) * BLOCK);
+        out.reserve(2 * (last - b * BLOCK));
+        for (int64_t id = b * BLOCK; id < last; ++id) {
+            if ((id % cols) + 1 < cols && id + 1 < n) out.push_back({int(id), int(id + 1), randomWeight(rng, spec)});
+            if (id + cols < n) out.push_back({int(id), int(id + cols), randomWeight(rng, spec)});
+        }
+    });
+}
+
+bool completeEdges(const GraphGenerator::Spec& spec, std::vector<GraphGenerator::Edge>& edges) {
+    uint64_t n = spec.n;
+    uint64_t rows = std::max<uint64_t>(1, BLOCK / n);
+    return generateBlocks((n + rows - 1) / rows, edges, [&spec, n, rows](uint64_t b, std::vector<GraphGenerator::Edge>& out) {
+        Rng rng(spec.seed, b);
+        uint64_t last = std::min(n, (b + 1) * rows);
+        for (uint64_t u = b * rows; u < last; ++u) {
+            for (uint64_t v = u + 1; v < n; ++v) out.push_back({int(u), int(v), randomWeight(rng, spec)});
+        }
+    });
+}
+
+// Chung-Lu: both endpoints drawn in proportion to vertex i's target degree (i + 1)^(-1 / (gamma - 1))
+bool powerLawEdges(const GraphGenerator::Spec& spec, std::vector<GraphGenerator::Edge>& edges) {
+    std::vector<double> cumulative(spec.n);
+    double total = 0.0;
+    for (int i = 0; i < spec.n; ++i) {
+        total += std::pow(double(i + 1), -1.0 / (POWER_LAW_EXPONENT - 1.0));
+        cumulative[i] = total;
+    }
+    auto draw = [&cumulative, total, &spec](Rng& rng) {
+        size_t i = std::upper_bound(cumulative.begin(), cumulative.end(), rng.unit() * total) - cumulative.begin();
+        return static_cast<int>(std::min<size_t>(i, spec.n - 1));
+    };
+    return generateBlocks(blocksFor(spec.m), edges, [&spec, &draw](uint64_t b, std::vector<GraphGenerator::Edge>& out) {
+        Rng rng(spec.seed, b);
+        uint64_t count = std::min(BLOCK, spec.m - b * BLOCK);
+        out.reserve(count);
+        for (uint64_t k = 0; k < count; ++k) {
+            int u = draw(rng);
+            int v = draw(rng);
+            // Hubs draw themselves often; a few retries keep the edge count close to m
+            for (int retry = 0; v == u && retry < 8; ++retry) v = draw(rng);
+            if (v == u) v = (u + 1) % spec.n;
+            out.push_back({u, v, randomWeight(rng, spec)});
+        }
+    });
+}
+
+// Points are bucketed into square cells no smaller than the radius, so each point only compares
+// against its own and the eight surrounding cells
+bool geometricEdges(const GraphGenerator::Spec& spec, std::vector<GraphGenerator::Edge>& edges) {
+    if (spec.m == 0) return true;
+    int n = spec.n;
+    std::vector<double> x(n), y(n);
+    ThreadPool::shared().parallelFor(blocksFor(n), [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            Rng rng(spec.seed, b);
+            for (uint64_t i = b * BLOCK; i < std::min<uint64_t>(n, (b + 1) * BLOCK); ++i) {
+                x[i] = rng.unit();
+                y[i] = rng.unit();
+            }
+        }
+    }, 1);
+
+    const double PI = 3.14159265358979323846;
+    double pairs = 0.5 * double(n) * double(n - 1);
+    double radius = std::min(std::sqrt(2.0), std::sqrt(double(spec.m) / (PI * pairs)));
+    double radius2 = radius * radius;
+    int64_t cells = std::max<int64_t>(1, std::min<int64_t>(static_cast<int64_t>(1.0 / radius),
+                                                           static_cast<int64_t>(std::ceil(std::sqrt(double(n))))));
+    auto cellOf = [cells](double coordinate) { return std::min<int64_t>(cells - 1, static_cast<int64_t>(coordinate * cells)); };
+
+    // Counting sort of the points by cell; within a cell they stay in id order
+    std::vector<size_t> start(cells * cells + 1, 0);
+    for (int i = 0; i < n; ++i) ++start[cellOf(y[i]) * cells + cellOf(x[i]) + 1];
+    for (int64_t c = 0; c < cells * cells; ++c) start[c + 1] += start[c];
+    std::vector<int> members(n);
+    {
+        std::vector<size_t> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; ++i) members[fill[cellOf(y[i]) * cells + cellOf(x[i])]++] = i;
+    }
+
+    return generateBlocks(blocksFor(n), edges, [&](uint64_t b, std::vector<GraphGenerator::Edge>& out) {
+        double span = double(int64_t(spec.maxWeight) - spec.minWeight);
+        for (uint64_t i = b * BLOCK; i < std::min<uint64_t>(n, (b + 1) * BLOCK); ++i) {
+            int64_t cx = cellOf(x[i]), cy = cellOf(y[i]);
+            for (int64_t ny = std::max<int64_t>(0, cy - 1); ny <= std::min(cells - 1, cy + 1); ++ny) {
+                for (int64_t nx = std::max<int64_t>(0, cx - 1); nx <= std::min(cells - 1, cx + 1); ++nx) {
+                    int64_t c = ny * cells + nx;
+                    for (size_t k = start[c]; k < start[c + 1]; ++k) {
+                        uint64_t j = members[k];
+                        if (j <= i) continue;
+                        double dx = x[i] - x[j], dy = y[i] - y[j];
+                        double d2 = dx * dx + dy * dy;
+                        if (d2 > radius2) continue;
+                        // In 64 bits, as the span can exceed INT_MAX; rounding may land just past it
+                        int64_t offset = std::llround(std::sqrt(d2) / radius * span);
+                        int weight = static_cast<int>(std::clamp<int64_t>(int64_t(spec.minWeight) + offset,
+                                                                          spec.minWeight, spec.maxWeight));
+                        out.push_back({int(i), int(j), weight});
+                        if (out.size() > GraphGenerator::MAX_EDGES) return;
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace
+
+bool GraphGenerator::parse(const std::vector<std::string>& parts, Spec& spec) {
+    if (parts.size() != 5 && parts.size() != 6) return false;
+    if (std::find(std::begin(FAMILIES), std::end(FAMILIES), parts[1]) == std::end(FAMILIES)) return false;
+    spec.family = parts[1];
+
+    long long n, m;
+    if (!parseInteger(parts[2], 1, INT_MAX, n) || !parseInteger(parts[3], 0, MAX_EDGES, m)) return false;
+    spec.n = static_cast<int>(n);
+    spec.m = static_cast<uint64_t>(m);
+
+    errno = 0;
+    char* end;
+    spec.seed = std::strtoull(parts[4].c_str(), &end, 10);
+    if (parts[4].empty() || parts[4][0] == '-' || *end != '\0' || errno == ERANGE) return false;
+
+    if (parts.size() == 6) {
+        size_t comma = parts[5].find(',');
+        if (comma == std::string::npos) return false;
+        long long lo, hi;
+        if (!parseInteger(parts[5].substr(0, comma), INT_MIN, INT_MAX, lo) ||
+            !parseInteger(parts[5].substr(comma + 1), INT_MIN, INT_MAX, hi) || lo > hi) {
+            return false;
+        }
+        spec.minWeight = static_cast<int>(lo);
+        spec.maxWeight = static_cast<int>(hi);
+    }
+    return true;
+}
+
+bool GraphGenerator::generate(const Spec& spec, std::vector<Edge>& edges) {
+    edges.clear();
+    if (spec.n < 2) return true;
+    // random, powerlaw and geometric are held to m by parse
+    if (spec.family == "random") {
+        return randomEdges(spec, edges);
+    } else if (spec.family == "grid") {
+        if (2 * uint64_t(spec.n) > MAX_EDGES) return false;
+        return gridEdges(spec, edges);
+    } else if (spec.family == "complete") {
+        if (uint64_t(spec.n) * uint64_t(spec.n - 1) / 2 > MAX_EDGES) return false;
+        return completeEdges(spec, edges);
+    } else if (spec.family == "powerlaw") {
+        return powerLawEdges(spec, edges);
+    } else if (spec.family == "geometric") {
+        return geometricEdges(spec, edges);
+    }
+    return false;
+}
@@ -0,0 +1,49 @@
+#ifndef GRAPH_GENERATOR_HPP
+#define GRAPH_GENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Synthetic graphs for load tests, built on the server so a large input costs no client I/O or
+// parsing. Each family is generated in fixed-size blocks on the solver pool, and every block
+// draws from its own stream seeded by (seed, block), so a seed yields the same edges in the same
+// order whatever the number of threads. That also makes the command safe to log and replay.
+//
+//   random     m edges with uniformly chosen endpoints (G(n, m); repeats collapse on ingest)
+//   grid       a near-square lattice over n vertices, edges to the right and below; m is ignored
+//   complete   every pair; m is ignored
+//   powerlaw   m edges with Chung-Lu endpoints, expected degrees following a power law of
+//              exponent 2.5
+//   geometric  n points in the unit square, joined when closer than the radius that gives about
+//              m edges; weights grow with distance
+class GraphGenerator {
+public:
+    struct Spec {
+        std::string family;
+        int n = 0;
+        uint64_t m = 0;
+        uint64_t seed = 0;
+        int minWeight = 1;
+        int maxWeight = 100;
+    };
+
+    struct Edge {
+        int u;  // 0-based
+        int v;
+        int weight;
+    };
+
+    // About 3 GiB of generated edges, before the graph copies them
+    static constexpr uint64_t MAX_EDGES = uint64_t(1) << 28;
+
+    // GenerateGraph <family> n m seed [min,max]
+    static bool parse(const std::vector<std::string>& parts, Spec& spec);
+
+    // False for an unknown family or a graph over MAX_EDGES: rejected up front when the family's
+    // edge count is known from n and m, and by stopping generation for geometric graphs, whose
+    // count is only expected to be near m
+    static bool generate(const Spec& spec, std::vector<Edge>& edges);
+};
+
+#endif // GRAPH_GENERATOR_HPP
@@ -0,0 +1,140 @@
+#ifndef GRAPH_VIEW_HPP
+#define GRAPH_VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Storage policies the solver kernels are instantiated over. Every view names its weight type
+// and enumerates each undirected edge through forEachEdge(f) as f(u, v, w) with u < v; views that
+// also offer neighbors(v) can feed solvers that walk neighborhoods.
+
+// Read-only CSR adjacency: the neighbors of v are entries[offsets[v] .. offsets[v + 1]) as
+// (vertex, weight) pairs, with every edge listed from both ends.
+// The arrays belong to the caller, usually a workspace arena.
+template <typename W>
+class BasicGraphView {
+public:
+    using Weight = W;
+    using Entry = std::pair<int, W>;
+
+    struct Range {
+        const Entry* first;
+        const Entry* last;
+
+        const Entry* begin() const { return first; }
+        const Entry* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    BasicGraphView(int n, const size_t* offsets, const Entry* entries)
+        : n(n), offsets(offsets), entries(entries) {}
+
+    int getNumVertices() const { return n; }
+    size_t getNumEdges() const { return offsets[n]; }  // Adjacency entries, both directions
+
+    Range neighbors(int v) const { return {entries + offsets[v], entries + offsets[v + 1]}; }
+
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for (int u = 0; u < n; ++u) {
+            for (const Entry& entry : neighbors(u)) {
+                if (u < entry.first) f(u, entry.first, entry.second);
+            }
+        }
+    }
+
+private:
+    int n;
+    const size_t* offsets;
+    const Entry* entries;
+};
+
+// The graph's own adjacency lists, where each stored edge appears once under its source. Solvers
+// that only need the edge list read it in place instead of from a CSR copy.
+template <typename W>
+class BasicAdjacencyView {
+public:
+    using Weight = W;
+    using Lists = std::vector<std::vector<std::pair<int, W>>>;
+
+    explicit BasicAdjacencyView(const Lists& adj) : adj(adj) {}
+
+    int getNumVertices() const { return static_cast<int>(adj.size()); }
+
+    // Edges stored under u, as (vertex, weight) pairs
+    const std::vector<std::pair<int, W>>& edgesOf(int u) const { return adj[u]; }
+
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for (int u = 0; u < getNumVertices(); ++u) {
+            for (const auto& entry : adj[u]) f(std::min(u, entry.first), std::max(u, entry.first), entry.second);
+        }
+    }
+
+private:
+    const Lists& adj;
+};
+
+// A mapped graph file's arrays (GraphFile.hpp layout), read where the file maps them: the same
+// once-per-edge lists as BasicAdjacencyView, with targets and weights in parallel arrays.
+template <typename W>
+class BasicMappedView {
+public:
+    using Weight = W;
+
+    struct Iterator {
+        const int32_t* target;
+        const W* weight;
+
+        std::pair<int, W> operator*() const { return {*target, *weight}; }
+        Iterator& operator++() {
+            ++target;
+            ++weight;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return target != other.target; }
+    };
+
+    struct Range {
+        Iterator first;
+        Iterator last;
+
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+        size_t size() const { return last.target - first.target; }
+    };
+
+    BasicMappedView(int n, const uint64_t* offsets, const int32_t* targets, const W* weights)
+        : n(n), offsets(offsets), targets(targets), weights(weights) {}
+
+    int getNumVertices() const { return n; }
+
+    Range edgesOf(int u) const {
+        return {{targets + offsets[u], weights + offsets[u]}, {targets + offsets[u + 1], weights + offsets[u + 1]}};
+    }
+
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for (int u = 0; u < n; ++u) {
+            for (uint64_t k = offsets[u]; k < offsets[u + 1]; ++k) {
+                f(std::min(u, int(targets[k])), std::max(u, int(targets[k])), weights[k]);
+            }
+        }
+    }
+
+private:
+    int n;
+    const uint64_t* offsets;
+    const int32_t* targets;
+    const W* weights;
+};
+
+// The weight type the graph stores and the protocol carries
+using GraphView = BasicGraphView<int>;
+using AdjacencyView = BasicAdjacencyView<int>;
+using MappedView = BasicMappedView<int32_t>;
+
+#endif // GRAPH_VIEW_HPP
@@ -0,0 +1,18 @@
+#include "MST.hpp"
+#include "EulerTour.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+
+void MST::calculateDistances() {
+    calculateDistances(SolverWorkspace::forThisThread());
+}
+
+// Linear work on the solver pool: the forest's Euler tour gives subtree sizes and depths, from
+// which both aggregates follow without a traversal per source vertex.
+void MST::calculateDistances(SolverWorkspace& workspace) {
+    ThreadPool& pool = ThreadPool::shared();
+    workspace.tour.build(*this, workspace.arena, pool);
+    TreeMetrics metrics = computeTreeMetrics(workspace.tour, workspace.arena, pool);
+    longestDistance = metrics.longest;
+    averageDistance = metrics.average;
+}
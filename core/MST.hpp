@@ -0,0 +1,85 @@
+#ifndef MST_HPP
+#define MST_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <limits>
+
+struct SolverWorkspace;
+
+struct MSTEdge {
+    int from;
+    int to;
+    int weight;
+};
+
+// One tree of a spanning forest, identified by its lowest vertex
+struct ComponentStats {
+    int root;
+    int vertices;
+    int64_t totalWeight;
+};
+
+// Result of a solve: the forest edges, one summary per tree and the distance metrics over it.
+// reset() keeps the edge storage, so a workspace-owned MST is reused without reallocating.
+class MST {
+public:
+    MST(int n = 0) : n(n), longestDistance(0), averageDistance(0.0) {}
+
+    void reset(int n) {
+        this->n = n;
+        edges.clear();
+        components.clear();
+        longestDistance = 0;
+        averageDistance = 0.0;
+    }
+
+    void addEdge(int from, int to, int weight) {
+        edges.push_back({from, to, weight});
+    }
+
+    int getNumVertices() const { return n; }
+    const std::vector<MSTEdge>& getEdges() const { return edges; }
+    const std::vector<ComponentStats>& getComponents() const { return components; }
+
+    // Lets the forest solver write per-component edge ranges in place from several threads
+    MSTEdge* resizeEdges(size_t count) {
+        edges.resize(count);
+        return edges.data();
+    }
+    void addComponent(const ComponentStats& component) { components.push_back(component); }
+
+    // 64-bit, so a large graph's total cannot overflow even though each weight is 32-bit
+    int64_t getTotalWeight() const {
+        int64_t total = 0;
+        for (const MSTEdge& edge : edges) {
+            total += edge.weight;
+        }
+        return total;
+    }
+
+    // Fills the longest and average distances over all connected vertex pairs
+    void calculateDistances();
+    void calculateDistances(SolverWorkspace& workspace);
+
+    int64_t getLongestDistance() const { return longestDistance; }
+    double getAverageDistance() const { return averageDistance; }
+
+    int getShortestDistance() const {
+        int minDist = std::numeric_limits<int>::max();
+        for (const MSTEdge& edge : edges) {
+            minDist = std::min(minDist, edge.weight);
+        }
+        return minDist;
+    }
+
+private:
+    int n;
+    std::vector<MSTEdge> edges;
+    std::vector<ComponentStats> components;
+    int64_t longestDistance;
+    double averageDistance;
+};
+
+#endif // MST_HPP
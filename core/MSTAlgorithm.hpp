@@ -0,0 +1,71 @@
+#ifndef MST_ALGORITHM_HPP
+#define MST_ALGORITHM_HPP
+
+#include "Graph.hpp"
+#include "GraphView.hpp"
+#include "MST.hpp"
+#include "SolverWorkspace.hpp"
+
+// Every algorithm is a kernel template over the storage policies in GraphView.hpp, instantiated
+// here for the graph's weight type; the virtual call picks the kernel once per component.
+class MSTAlgorithm {
+public:
+    // Solves one connected, undirected graph into `mst`, taking every working array from the
+    // workspace arena. Implementations must be safe to call from several threads at once.
+    virtual void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) = 0;
+    // Same, reading a connected graph's adjacency lists in place. Returns false without solving
+    // if the algorithm walks neighborhoods and so needs the CSR view.
+    virtual bool solveEdgeList(const AdjacencyView&, SolverWorkspace&, MST&) { return false; }
+    // Same, reading a loaded graph file where it is mapped
+    virtual bool solveEdgeList(const MappedView&, SolverWorkspace&, MST&) { return false; }
+    virtual ~MSTAlgorithm() = default;
+
+    // Minimum spanning forest of the whole graph, one tree per connected component
+    void solve(const Graph& graph, SolverWorkspace& workspace, MST& forest);
+    MST solve(const Graph& graph);
+
+private:
+    // The forest over either edge list storage; EdgeList is AdjacencyView or MappedView
+    template <typename EdgeList>
+    void solveForest(const EdgeList& adj, SolverWorkspace& workspace, MST& forest);
+};
+
+class BoruvkaAlgorithm : public MSTAlgorithm {
+public:
+    using MSTAlgorithm::solve;
+    void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const AdjacencyView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const MappedView& graph, SolverWorkspace& workspace, MST& mst) override;
+};
+
+class PrimAlgorithm : public MSTAlgorithm {
+public:
+    using MSTAlgorithm::solve;
+    void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) override;
+};
+
+class KruskalAlgorithm : public MSTAlgorithm {
+public:
+    using MSTAlgorithm::solve;
+    void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const AdjacencyView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const MappedView& graph, SolverWorkspace& workspace, MST& mst) override;
+};
+
+class TarjanAlgorithm : public MSTAlgorithm {
+public:
+    using MSTAlgorithm::solve;
+    void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const AdjacencyView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const MappedView& graph, SolverWorkspace& workspace, MST& mst) override;
+};
+
+class IntegerMSTAlgorithm : public MSTAlgorithm {
+public:
+    using MSTAlgorithm::solve;
+    void solve(const GraphView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const AdjacencyView& graph, SolverWorkspace& workspace, MST& mst) override;
+    bool solveEdgeList(const MappedView& graph, SolverWorkspace& workspace, MST& mst) override;
+};
+
+#endif // MST_ALGORITHM_HPP
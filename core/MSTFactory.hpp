@@ -0,0 +1,49 @@
+#ifndef MST_FACTORY_HPP
+#define MST_FACTORY_HPP
+
+#include "MSTAlgorithm.hpp"
+#include "CostModel.hpp"
+#include <memory>
+#include <string>
+#include <stdexcept>
+
+class MSTFactory {
+    template <typename Algorithm>
+    static std::unique_ptr<MSTAlgorithm> make() {
+        return std::make_unique<Algorithm>();
+    }
+
+public:
+    using Create = std::unique_ptr<MSTAlgorithm> (*)();
+
+    struct Entry {
+        const char* name;
+        Create create;
+    };
+
+    // Every algorithm a request can name, fixed at compile time
+    static constexpr Entry REGISTRY[] = {
+        {"Boruvka", &make<BoruvkaAlgorithm>},
+        {"Prim", &make<PrimAlgorithm>},
+        {"Kruskal", &make<KruskalAlgorithm>},
+        {"Tarjan", &make<TarjanAlgorithm>},
+        {"Integer", &make<IntegerMSTAlgorithm>},
+    };
+
+    static std::unique_ptr<MSTAlgorithm> createAlgorithm(const std::string& algorithmName) {
+        for (const Entry& entry : REGISTRY) {
+            if (algorithmName == entry.name) return entry.create();
+        }
+        throw std::invalid_argument("Unknown algorithm: " + algorithmName);
+    }
+
+    // Like createAlgorithm, but "Auto" is resolved against the graph's shape by the active cost
+    // model. `chosen` receives the name of the algorithm actually created.
+    static std::unique_ptr<MSTAlgorithm> createAlgorithm(const std::string& algorithmName, const Graph& graph,
+                                                         std::string& chosen) {
+        chosen = algorithmName == "Auto" ? CostModel::active().choose(graph) : algorithmName;
+        return createAlgorithm(chosen);
+    }
+};
+
+#endif // MST_FACTORY_HPP
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "MutationLog.hpp"
+#include "GraphFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct RecordHeader {
+    uint32_t length;    // Payload bytes
+    uint32_t checksum;  // FNV-1a over lsn and payload
+    uint64_t lsn;
+};
+
+uint32_t checksum(uint64_t lsn, const char* data, size_t size) {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const char* p, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            h ^= static_cast<unsigned char>(p[i]);
+            h *= 16777619u;
+        }
+    };
+    mix(reinterpret_cast<const char*>(&lsn), sizeof lsn);
+    mix(data, size);
+    return h;
+}
+
+void encode(std::string& out, uint64_t lsn, const std::vector<std::string>& parts) {
+    std::string payload;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i > 0) payload += ' ';
+        payload += parts[i];
+    }
+    RecordHeader h{static_cast<uint32_t>(payload.size()), checksum(lsn, payload.data(), payload.size()), lsn};
+    out.append(reinterpret_cast<const char*>(&h), sizeof h);
+    out += payload;
+}
+
+// Bytes at the front of a batch holding its records up to lsn; batches are in LSN order
+size_t prefixThrough(const std::string& batch, uint64_t lsn) {
+    size_t pos = 0;
+    while (pos + sizeof(RecordHeader) <= batch.size()) {
+        RecordHeader h;
+        std::memcpy(&h, batch.data() + pos, sizeof h);
+        if (h.lsn > lsn) break;
+        pos += sizeof h + h.length;
+    }
+    return pos;
+}
+
+void syncDirectory(const std::string& directory) {
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd != -1) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+} // namespace
+
+MutationLog::MutationLog(const std::string& directory,
+                         std::chrono::microseconds commitWindow,
+                         uint64_t checkpointInterval)
+    : directory(directory),
+      logPath(directory + "/graph.wal"),
+      snapshotPath(directory + "/graph.snapshot"),
+      commitWindow(commitWindow),
+      checkpointInterval(checkpointInterval),
+      logFd(-1), appendedLsn(0), pendingLsn(0), durableLsn(0), failedLsn(0), owedFrom(0),
+      sinceCheckpoint(0), queuedUpto(0), checkpointing(false), inFlightUpto(0), logSize(0), stop(false) {}
+
+MutationLog::~MutationLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    flushCondition.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (logFd != -1) {
+        close(logFd);
+    }
+}
+
+bool MutationLog::isMutation(const std::string& cmd) {
+    return cmd == "NewGraph" || cmd == "NewEdge" || cmd == "RemoveEdge" || cmd == "LoadGraph" || cmd == "Batch" ||
+           cmd == "GenerateGraph";
+}
+
+bool MutationLog::recover(Graph& graph) {
+    if (mkdir(directory.c_str(), 0755) == -1 && errno != EEXIST) {
+        perror("mkdir");
+        return false;
+    }
+
+    uint64_t snapshotLsn = 0;
+    if (access(snapshotPath.c_str(), F_OK) == 0) {
+        MappedGraphFile snapshot;
+        if (!snapshot.open(snapshotPath)) return false;
+        snapshotLsn = snapshot.getSequence();
+        snapshot.close();
+        if (!graph.LoadGraph(snapshotPath)) return false;
+    }
+
+    logFd = open(logPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (logFd == -1) {
+        perror("open");
+        return false;
+    }
+    syncDirectory(directory);
+
+    appendedLsn = pendingLsn = durableLsn = snapshotLsn;
+    if (!replay(graph, snapshotLsn)) return false;
+
+    flusher = std::thread(&MutationLog::flusherLoop, this);
+    std::cout << "Recovered graph from " << directory << " at LSN " << appendedLsn
+              << " (" << sinceCheckpoint << " records replayed)" << std::endl;
+    return true;
+}
+
+bool MutationLog::replay(Graph& graph, uint64_t snapshotLsn) {
+    std::string log;
+    char buf[1 << 16];
+    ssize_t nbytes;
+    while ((nbytes = pread(logFd, buf, sizeof buf, log.size())) != 0) {
+        if (nbytes < 0) {
+            if (errno == EINTR) continue;
+            perror("pread");
+            return false;
+        }
+        log.append(buf, nbytes);
+    }
+
+    size_t pos = 0;
+    while (pos + sizeof(RecordHeader) <= log.size()) {
+        RecordHeader h;
+        std::memcpy(&h, log.data() + pos, sizeof h);
+        const char* payload = log.data() + pos + sizeof h;
+        if (pos + sizeof h + h.length > log.size() || h.checksum != checksum(h.lsn, payload, h.length)) {
+            break;
+        }
+        pos += sizeof h + h.length;
+
+        // Records up to the snapshot LSN are already folded into the snapshot
+        if (h.lsn <= snapshotLsn) continue;
+        if (h.lsn <= appendedLsn) {
+            std::cerr << "Mutation log: record " << h.lsn << " out of order after " << appendedLsn << "\n";
+            return false;
+        }
+
+        std::istringstream iss(std::string(payload, h.length));
+        std::vector<std::string> parts;
+        std::string part;
+        while (iss >> part) parts.push_back(part);
+        graph.eval(parts);
+
+        appendedLsn = pendingLsn = durableLsn = h.lsn;
+        ++sinceCheckpoint;
+    }
+
+    // Drop a torn tail left by a crash in the middle of a write
+    logSize = static_cast<off_t>(pos);
+    if (pos != log.size()) {
+        std::cerr << "Mutation log: discarding " << log.size() - pos << " bytes of torn tail\n";
+        if (ftruncate(logFd, pos) == -1 || fdatasync(logFd) == -1) {
+            perror("ftruncate");
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t MutationLog::append(const std::vector<std::string>& parts, const Graph& graph) {
+    if (parts.empty() || !isMutation(parts[0])) return 0;
+
+    uint64_t lsn;
+    bool take;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lsn = ++appendedLsn;
+        // A loaded file may change or vanish, so LoadGraph is captured by a snapshot instead. Until
+        // one is written, later records build on the loaded graph and wait for it too.
+        if (parts[0] == "LoadGraph") {
+            if (owedFrom == 0) owedFrom = lsn;
+        } else {
+            encode(pending, lsn, parts);
+            pendingLsn = lsn;
+        }
+        bool due = ++sinceCheckpoint >= checkpointInterval;
+        if (owedFrom != 0) {
+            // Taken again only if no queued or running snapshot covers the owed LSN, so after a
+            // failed snapshot the next mutation retries it
+            uint64_t covered = std::max(queuedSnapshot ? queuedUpto : 0, checkpointing ? inFlightUpto : 0);
+            take = covered < owedFrom;
+        } else {
+            take = due && !queuedSnapshot && !checkpointing;
+        }
+    }
+
+    // The image is the only checkpoint work done under the graph lock; a mapped graph shares its
+    // file, so taking one is cheap
+    if (take) {
+        std::unique_ptr<Graph::Image> snapshot;
+        try {
+            snapshot = std::make_unique<Graph::Image>(graph.image());
+        } catch (const std::bad_alloc&) {
+            std::cerr << "checkpoint: out of memory taking an image of the graph\n";
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        sinceCheckpoint = 0;
+        if (snapshot) {
+            queuedSnapshot.swap(snapshot);  // A replaced image is freed on the way out
+            queuedUpto = lsn;
+        } else {
+            if (owedFrom != 0) failedLsn = std::max(failedLsn, lsn);
+            durableCondition.notify_all();
+        }
+    }
+    flushCondition.notify_one();
+    return lsn;
+}
+
+bool MutationLog::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    durableCondition.wait(lock, [this, lsn] { return durableLsn >= lsn || failedLsn >= lsn; });
+    return durableLsn >= lsn;
+}
+
+void MutationLog::flusherLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        flushCondition.wait(lock, [this] { return stop || !pending.empty() || queuedSnapshot; });
+        if (queuedSnapshot) {
+            checkpoint(lock);
+            continue;
+        }
+        if (pending.empty()) return;
+
+        // Hold the batch open for one commit window so concurrent writers share the sync
+        if (!stop && commitWindow.count() > 0) {
+            flushCondition.wait_for(lock, commitWindow, [this] { return stop; });
+        }
+
+        // Take the batch only once the file is ours, so a checkpoint cannot write newer records first
+        lock.unlock();
+        std::unique_lock<std::mutex> io(ioMutex);
+        lock.lock();
+        if (pending.empty()) continue;
+        std::string batch;
+        batch.swap(pending);
+        uint64_t upto = pendingLsn;
+        lock.unlock();
+
+        bool intact;
+        bool written = writeRecords(batch, intact);
+        io.unlock();
+
+        lock.lock();
+        settle(batch, upto, written, intact);
+        if (!written) {
+            if (stop) return;
+            flushCondition.wait_for(lock, RETRY_DELAY, [this] { return stop; });
+        }
+    }
+}
+
+bool MutationLog::writeAll(const std::string& data) {
+    const char* p = data.data();
+    size_t size = data.size();
+    while (size > 0) {
+        ssize_t written = write(logFd, p, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        size -= written;
+    }
+    return true;
+}
+
+// Called with ioMutex held. On failure the file is cut back to its last whole record, so later
+// batches never land behind a torn one; intact is false if even that failed.
+bool MutationLog::writeRecords(const std::string& batch, bool& intact) {
+    intact = true;
+    if (writeAll(batch) && fdatasync(logFd) == 0) {
+        logSize += static_cast<off_t>(batch.size());
+        return true;
+    }
+    perror("mutation log");
+    if (ftruncate(logFd, logSize) == -1) {
+        perror("ftruncate");
+        intact = false;
+    }
+    return false;
+}
+
+// Called with mutex held, after writeRecords of a batch whose highest LSN is lastLsn
+void MutationLog::settle(std::string& batch, uint64_t lastLsn, bool written, bool intact) {
+    if (written) {
+        durableLsn = std::max(durableLsn, owedFrom != 0 ? std::min(lastLsn, owedFrom - 1) : lastLsn);
+    } else {
+        failedLsn = std::max(failedLsn, lastLsn);
+        if (intact) {
+            // Retried ahead of anything appended since, keeping the log in LSN order
+            batch += pending;
+            pending.swap(batch);
+        } else if (owedFrom == 0) {
+            // The torn bytes hide whatever follows them from replay until a snapshot replaces the log
+            owedFrom = durableLsn + 1;
+        }
+    }
+    durableCondition.notify_all();
+}
+
+// Called on the flusher with mutex held. Writes the queued image as the snapshot, then the records
+// after it to the emptied log; the records it covers only go to the log if it cannot be written.
+void MutationLog::checkpoint(std::unique_lock<std::mutex>& lock) {
+    std::unique_ptr<Graph::Image> image = std::move(queuedSnapshot);
+    uint64_t upto = queuedUpto;
+    checkpointing = true;
+    inFlightUpto = upto;
+    lock.unlock();
+
+    std::unique_lock<std::mutex> io(ioMutex);
+    lock.lock();
+    std::string batch;
+    batch.swap(pending);
+    uint64_t lastRecord = pendingLsn;
+    lock.unlock();
+
+    bool saved = image->save(snapshotPath, upto);
+    image.reset();
+    if (saved) {
+        syncDirectory(directory);
+        if (ftruncate(logFd, 0) == -1 || fdatasync(logFd) == -1) {
+            perror("ftruncate");  // Leftover records are at or below the snapshot LSN, so replay skips them
+        } else {
+            logSize = 0;
+        }
+        batch.erase(0, prefixThrough(batch, upto));
+    } else {
+        perror("checkpoint");
+    }
+    bool intact = true;
+    bool written = batch.empty() || writeRecords(batch, intact);
+    io.unlock();
+
+    lock.lock();
+    checkpointing = false;
+    if (saved) {
+        durableLsn = std::max(durableLsn, upto);
+        if (owedFrom != 0 && owedFrom <= upto) owedFrom = 0;
+    } else {
+        // Without a snapshot, whatever only a snapshot can cover stays owed, and its waiters fail,
+        // except those a newer queued image still covers
+        if (owedFrom != 0) failedLsn = std::max(failedLsn, queuedSnapshot ? upto : appendedLsn);
+    }
+    if (batch.empty()) {
+        durableCondition.notify_all();
+    } else {
+        settle(batch, lastRecord, written, intact);
+    }
+}
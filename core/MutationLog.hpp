@@ -0,0 +1,90 @@
+#ifndef MUTATION_LOG_HPP
+#define MUTATION_LOG_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include "Graph.hpp"
+
+// Write-ahead log of graph mutations with group commit.
+//
+// Mutations are appended to an in-memory buffer while the caller still holds the graph lock;
+// a flusher thread writes everything buffered during one commit window with a single
+// write + fdatasync. Callers wait for durability after releasing the graph lock, so concurrent
+// mutations share one sync. Every `checkpointInterval` records an image of the graph is taken
+// under the graph lock and the flusher writes it to a snapshot (binary graph file carrying the last
+// LSN) and truncates the log, which bounds recovery to loading one snapshot plus replaying at
+// most one interval of records. Only taking the image, not the write and sync, holds up other
+// clients.
+//
+// Batches are taken from the buffer under the I/O lock, so the log always holds records in LSN
+// order. A batch whose write fails is cut from the file and retried ahead of newer records; only
+// its own waiters are told it failed.
+class MutationLog {
+public:
+    MutationLog(const std::string& directory,
+                std::chrono::microseconds commitWindow = std::chrono::microseconds(200),
+                uint64_t checkpointInterval = 100000);
+    ~MutationLog();
+    MutationLog(const MutationLog&) = delete;
+    MutationLog& operator=(const MutationLog&) = delete;
+
+    // Rebuilds graph from the snapshot and log, then opens the log for appending.
+    bool recover(Graph& graph);
+
+    // Records an already applied command. Must be called under the graph lock, which is also
+    // what makes a checkpoint's image of the graph match the LSN handed out.
+    // Returns the LSN to wait on, or 0 if the command does not change the graph.
+    uint64_t append(const std::vector<std::string>& parts, const Graph& graph);
+
+    // Blocks until the record with this LSN is on disk. Returns false if the batch or snapshot
+    // carrying it failed; the command stays applied in memory and later records can still succeed.
+    bool waitDurable(uint64_t lsn);
+
+    static bool isMutation(const std::string& cmd);
+
+private:
+    static constexpr std::chrono::milliseconds RETRY_DELAY{100};  // Before rewriting a failed batch
+
+    void flusherLoop();
+    bool writeAll(const std::string& data);
+    bool writeRecords(const std::string& batch, bool& intact);
+    void settle(std::string& batch, uint64_t lastLsn, bool written, bool intact);
+    void checkpoint(std::unique_lock<std::mutex>& lock);
+    bool replay(Graph& graph, uint64_t snapshotLsn);
+
+    std::string directory;
+    std::string logPath;
+    std::string snapshotPath;
+    std::chrono::microseconds commitWindow;
+    uint64_t checkpointInterval;
+
+    int logFd;
+    std::string pending;          // Encoded records not yet handed to the flusher
+    uint64_t appendedLsn;         // Highest LSN handed out
+    uint64_t pendingLsn;          // Highest LSN encoded into a log record
+    uint64_t durableLsn;          // Every LSN up to this is in the log or the snapshot
+    uint64_t failedLsn;           // Waiters up to this LSN that are not yet durable have failed
+    uint64_t owedFrom;            // If not 0, the first LSN only a snapshot can make durable
+    uint64_t sinceCheckpoint;     // Records appended since the last snapshot
+    std::unique_ptr<Graph::Image> queuedSnapshot;  // The graph at queuedUpto, for the flusher to write
+    uint64_t queuedUpto;
+    bool checkpointing;           // The flusher is writing a snapshot of the graph at inFlightUpto
+    uint64_t inFlightUpto;
+    off_t logSize;                // Bytes of whole records in the log, guarded by ioMutex
+    bool stop;
+
+    std::mutex mutex;             // Guards the fields above
+    std::mutex ioMutex;           // Serializes writes/syncs to the log file and snapshot
+    std::condition_variable flushCondition;
+    std::condition_variable durableCondition;
+    std::thread flusher;
+};
+
+#endif // MUTATION_LOG_HPP
@@ -0,0 +1,130 @@
+#ifndef SOLVER_WORKSPACE_HPP
+#define SOLVER_WORKSPACE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "EulerTour.hpp"
+#include "MST.hpp"
+
+// Bump allocator for solver scratch arrays. Memory is only released by rewinding, and blocks are
+// kept across rewinds up to the retained limit (--arena-retain-mb, 256 MB by default), so once a
+// thread has solved a graph of some size, solving it again allocates nothing. A graph whose
+// scratch space is over the limit allocates it afresh on every solve. Arrays are uninitialized;
+// callers fill what they read.
+class Arena {
+public:
+    Arena() : current(0), offset(0) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    // Everything allocated after `Scope` was created is released when it goes out of scope
+    class Scope {
+    public:
+        explicit Scope(Arena& arena) : arena(arena), block(arena.current), offset(arena.offset) {}
+        ~Scope() { arena.rewind(block, offset); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Arena& arena;
+        size_t block;
+        size_t offset;
+    };
+
+    // Bytes each thread keeps between solves; set before the first solve
+    static void configureRetained(size_t bytes) { retainedLimit() = bytes; }
+    static constexpr size_t DEFAULT_RETAINED = size_t(256) << 20;
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& b : blocks) total += b.size;
+        return total;
+    }
+
+private:
+    static constexpr size_t MIN_BLOCK = size_t(1) << 20;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void* allocateBytes(size_t bytes, size_t align) {
+        if (current == 0 && offset == 0 && blocks.size() > 1) merge();
+        while (current < blocks.size()) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(blocks[current].data.get());
+            size_t start = ((base + offset + align - 1) & ~(uintptr_t(align) - 1)) - base;
+            if (start + bytes <= blocks[current].size) {
+                offset = start + bytes;
+                return blocks[current].data.get() + start;
+            }
+            ++current;
+            offset = 0;
+        }
+        size_t size = std::max({MIN_BLOCK, bytes + align, blocks.empty() ? 0 : blocks.back().size * 2});
+        blocks.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+        return allocateBytes(bytes, align);
+    }
+
+    static size_t& retainedLimit() {
+        static size_t limit = DEFAULT_RETAINED;
+        return limit;
+    }
+
+    // Rewinding runs in Scope's destructor, so it only frees: back at the start and over the
+    // limit, the smaller blocks go first, as blocks only grow and the largest serves the next
+    // large solve; it goes too only if it alone is over the limit
+    void rewind(size_t block, size_t off) {
+        current = block;
+        offset = off;
+        if (current == 0 && offset == 0) {
+            size_t total = capacity();
+            size_t keep = 0;
+            while (total > retainedLimit() && keep < blocks.size()) total -= blocks[keep++].size;
+            blocks.erase(blocks.begin(), blocks.begin() + keep);
+        }
+    }
+
+    // A run that spilled over several blocks is merged into one before the next run starts, so
+    // a run of the same size fits without a block change. Without memory for it, the blocks stay.
+    void merge() {
+        size_t total = capacity();
+        std::unique_ptr<char[]> data(new (std::nothrow) char[total]);
+        if (!data) return;
+        blocks.clear();
+        blocks.push_back(Block{std::move(data), total});
+    }
+
+    std::vector<Block> blocks;
+    size_t current;
+    size_t offset;
+};
+
+// Per-thread scratch state for solvers and tree metrics: the arena for working arrays, a result
+// forest whose storage is reused by the next solve on the same thread, a scratch tree for the
+// component the thread is solving on behalf of a forest solve, and the Euler tour of the last
+// forest whose metrics were computed.
+struct SolverWorkspace {
+    Arena arena;
+    MST result;
+    MST component;
+    EulerTour tour;
+
+    static SolverWorkspace& forThisThread() {
+        thread_local SolverWorkspace workspace;
+        return workspace;
+    }
+};
+
+#endif // SOLVER_WORKSPACE_HPP
@@ -0,0 +1,166 @@
+#include "MSTAlgorithm.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+
+namespace {
+
+// Lock-free union-find for the components pass. A root only ever gets hooked under a smaller
+// root, so parents strictly decrease along a path and each component ends up labelled by its
+// lowest vertex whatever order the threads run in.
+int findRoot(int* parent, int x) {
+    while (true) {
+        int p = __atomic_load_n(&parent[x], __ATOMIC_ACQUIRE);
+        if (p == x) return x;
+        int grandparent = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+        if (grandparent != p) {
+            // Path halving; losing the race only means the shortcut is not taken
+            __atomic_compare_exchange_n(&parent[x], &p, grandparent, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+        x = grandparent;
+    }
+}
+
+void uniteRoots(int* parent, int u, int v) {
+    while (true) {
+        u = findRoot(parent, u);
+        v = findRoot(parent, v);
+        if (u == v) return;
+        if (u > v) std::swap(u, v);
+        int expected = v;
+        if (__atomic_compare_exchange_n(&parent[v], &expected, u, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+// Components are found first, then each one is copied into an undirected CSR view and solved on
+// its own by whichever pool thread picks it up. Trees land in the forest in component order, so
+// the result does not depend on scheduling.
+void MSTAlgorithm::solve(const Graph& graph, SolverWorkspace& workspace, MST& forest) {
+    graph.visitEdges([&](const auto& adj) { solveForest(adj, workspace, forest); });
+}
+
+template <typename EdgeList>
+void MSTAlgorithm::solveForest(const EdgeList& adj, SolverWorkspace& workspace, MST& forest) {
+    Arena::Scope scope(workspace.arena);
+    Arena& arena = workspace.arena;
+    ThreadPool& pool = ThreadPool::shared();
+    int n = adj.getNumVertices();
+    forest.reset(n);
+
+    // Connected components, treating every stored edge as undirected
+    int* label = arena.allocate<int>(n);
+    pool.parallelFor(n, [label](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) label[v] = static_cast<int>(v);
+    });
+    pool.parallelFor(n, [label, &adj](size_t begin, size_t end) {
+        for (size_t u = begin; u < end; ++u) {
+            for (const auto& edge : adj.edgesOf(u)) uniteRoots(label, static_cast<int>(u), edge.first);
+        }
+    });
+    // Other threads are still reading these entries while halving their own paths, so the final
+    // label is stored atomically too
+    pool.parallelFor(n, [label](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            __atomic_store_n(&label[v], findRoot(label, static_cast<int>(v)), __ATOMIC_RELAXED);
+        }
+    });
+
+    // Number components by their lowest vertex and give every vertex a local id
+    int* component = arena.allocate<int>(n);
+    int* localId = arena.allocate<int>(n);
+    int* start = arena.allocate<int>(n + 1);  // Component c owns members[start[c] .. start[c + 1])
+    int numComponents = 0;
+    for (int v = 0; v < n; ++v) {
+        if (label[v] == v) start[numComponents++] = 0;
+        int c = label[v] == v ? numComponents - 1 : component[label[v]];
+        component[v] = c;
+        localId[v] = start[c]++;
+    }
+    int total = 0;
+    for (int c = 0; c <= numComponents; ++c) {
+        int size = c < numComponents ? start[c] : 0;
+        start[c] = total;
+        total += size;
+    }
+    int* members = arena.allocate<int>(n);
+    for (int v = 0; v < n; ++v) members[start[component[v]] + localId[v]] = v;
+
+    // A tree over k vertices has k - 1 edges, so every component's slice is known up front
+    MSTEdge* edges = forest.resizeEdges(n - numComponents);
+    int* found = arena.allocate<int>(numComponents);
+    int64_t* weight = arena.allocate<int64_t>(numComponents);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    pool.parallelFor(numComponents, [&](size_t begin, size_t end) {
+        SolverWorkspace& local = SolverWorkspace::forThisThread();
+        for (size_t c = begin; c < end; ++c) {
+            const int* vertices = members + start[c];
+            int size = start[c + 1] - start[c];
+            found[c] = 0;
+            weight[c] = 0;
+            if (size == 1) continue;
+
+            try {
+                // A connected graph's edge list is already its only component's, with the same
+                // vertex ids, so edge-list solvers skip the CSR copy
+                if (numComponents != 1 || !solveEdgeList(adj, local, local.component)) {
+                    Arena::Scope componentScope(local.arena);
+                    size_t* offsets = local.arena.allocate<size_t>(size + 1);
+                    std::fill(offsets, offsets + size + 1, 0);
+                    for (int k = 0; k < size; ++k) {
+                        for (const auto& edge : adj.edgesOf(vertices[k])) {
+                            ++offsets[k + 1];
+                            ++offsets[localId[edge.first] + 1];
+                        }
+                    }
+                    for (int k = 0; k < size; ++k) offsets[k + 1] += offsets[k];
+                    size_t* fill = local.arena.allocate<size_t>(size);
+                    std::copy(offsets, offsets + size, fill);
+                    auto* entries = local.arena.allocate<std::pair<int, int>>(offsets[size]);
+                    for (int k = 0; k < size; ++k) {
+                        for (const auto& edge : adj.edgesOf(vertices[k])) {
+                            int other = localId[edge.first];
+                            entries[fill[k]++] = {other, edge.second};
+                            entries[fill[other]++] = {k, edge.second};
+                        }
+                    }
+
+                    solve(GraphView(size, offsets, entries), local, local.component);
+                }
+
+                MSTEdge* slice = edges + (start[c] - static_cast<int>(c));
+                for (const MSTEdge& e : local.component.getEdges()) {
+                    if (found[c] == size - 1) break;
+                    slice[found[c]++] = {vertices[e.from], vertices[e.to], e.weight};
+                    weight[c] += e.weight;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+        }
+    });
+    if (failure) std::rethrow_exception(failure);
+
+    // Close gaps left by a solver that returned fewer edges than a spanning tree needs
+    size_t kept = 0;
+    for (int c = 0; c < numComponents; ++c) {
+        MSTEdge* slice = edges + (start[c] - c);
+        std::copy(slice, slice + found[c], edges + kept);
+        kept += found[c];
+        forest.addComponent({members[start[c]], start[c + 1] - start[c], weight[c]});
+    }
+    forest.resizeEdges(kept);
+}
+
+MST MSTAlgorithm::solve(const Graph& graph) {
+    MST forest;
+    solve(graph, SolverWorkspace::forThisThread(), forest);
+    return forest;
+}
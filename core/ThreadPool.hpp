@@ -0,0 +1,313 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "ChaseLevDeque.hpp"
+#include "Topology.hpp"
+
+// Work-stealing scheduler shared by the solvers and the pooled engines.
+//
+// Every worker owns a Chase-Lev deque of fork/join tasks. parallelFor halves its range, pushes
+// one half and recurses into the other, so idle threads steal the oldest and largest halves;
+// thieves try victims on their own NUMA node first. A thread outside the pool that starts a loop
+// borrows a deque for the loop's duration and works on it like any worker, and loops nested in
+// pool tasks fork onto the same deques, so nothing runs on extra threads.
+//
+// Independent tasks, such as a pooled engine's commands, go through submit() onto a shared FIFO.
+// Idle workers take those before stealing, so a large solve does not starve connections. A
+// thread waiting for a stolen half only steals fork/join work, never a submitted task, so its
+// join is not held up behind an unrelated command.
+//
+// An exception thrown by a loop body is carried back to the frame that forked the range, which
+// still joins its stolen half before unwinding, and parallelFor rethrows it to its caller. A
+// submitted task that throws is reported and dropped, as a worker has no caller to hand it to.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Starts numThreads - 1 workers, but at least one so submitted tasks always have a thread
+    explicit ThreadPool(size_t numThreads)
+        : numWorkers(numThreads > 1 ? numThreads - 1 : 1),
+          slots(new Worker[numWorkers + MAX_GUESTS]),
+          numSlots(numWorkers) {
+        for (size_t i = 0; i < numWorkers + MAX_GUESTS; ++i) slots[i].pool = this;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            slots[i].inUse = true;
+            threads.emplace_back(&ThreadPool::run, this, &slots[i]);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stop = true;
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads a loop started from outside the pool can run on, the caller included
+    size_t size() const { return numWorkers + 1; }
+
+    // Runs task on a worker; tasks start in submission order
+    void submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(submittedMutex);
+            submitted.push_back(std::move(task));
+            ++numSubmitted;
+        }
+        signal();
+    }
+
+    // Calls body(begin, end) over disjoint chunks covering [0, count). Returns when all are done.
+    template <typename F>
+    void parallelFor(size_t count, F&& body, size_t grain = 0) {
+        if (count == 0) return;
+        if (grain == 0) grain = std::max<size_t>(1, count / (size() * 8));
+        if (count <= grain) {
+            body(size_t(0), count);
+            return;
+        }
+
+        using Body = std::remove_reference_t<F>;
+        Worker*& self = current();
+        if (self && self->pool == this) {
+            forkRange<Body>(*self, body, 0, count, grain);
+            return;
+        }
+        Worker* guest = attach();
+        if (!guest) {
+            body(size_t(0), count);
+            return;
+        }
+        Worker* previous = self;
+        self = guest;
+        std::exception_ptr error;
+        try {
+            forkRange<Body>(*guest, body, 0, count, grain);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        self = previous;
+        guest->inUse.store(false, std::memory_order_release);
+        if (error) std::rethrow_exception(error);
+    }
+
+    // Pool used by the solvers and pooled engines; sized by configure() before first use
+    static ThreadPool& shared() {
+        static ThreadPool pool(configuredThreads());
+        return pool;
+    }
+
+    static void configure(size_t numThreads) { configuredThreads() = std::max<size_t>(1, numThreads); }
+
+private:
+    static constexpr size_t MAX_GUESTS = 64;  // Outside threads inside a loop at the same time
+
+    // A stealable piece of a loop, living on the stack of the frame that forked it
+    struct ForkTask {
+        void (*execute)(ForkTask*);
+        std::exception_ptr error{};  // Thrown by a thief running it, rethrown by the owner's join
+        std::atomic<bool> done{false};
+    };
+
+    template <typename F>
+    struct RangeTask : ForkTask {
+        ThreadPool* pool;
+        F* body;
+        size_t begin;
+        size_t end;
+        size_t grain;
+
+        RangeTask(ThreadPool* pool, F* body, size_t begin, size_t end, size_t grain)
+            : ForkTask{&RangeTask::runRange}, pool(pool), body(body), begin(begin), end(end), grain(grain) {}
+
+        static void runRange(ForkTask* task) {
+            RangeTask* range = static_cast<RangeTask*>(task);
+            range->pool->template forkRange<F>(*current(), *range->body, range->begin, range->end, range->grain);
+        }
+    };
+
+    struct alignas(64) Worker {
+        ChaseLevDeque<ForkTask> deque;
+        ThreadPool* pool = nullptr;
+        std::atomic<int> node{0};
+        std::atomic<bool> inUse{false};  // Guest slots: borrowed by an outside thread
+    };
+
+    static Worker*& current() {
+        thread_local Worker* worker = nullptr;
+        return worker;
+    }
+
+    static size_t& configuredThreads() {
+        static size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        return threads;
+    }
+
+    template <typename F>
+    void forkRange(Worker& self, F& body, size_t begin, size_t end, size_t grain) {
+        if (end - begin > grain) {
+            size_t mid = begin + (end - begin) / 2;
+            RangeTask<F> right(this, &body, mid, end, grain);
+            if (self.deque.push(&right)) {
+                signal();
+                // right lives in this frame, so it is joined even when the left half throws
+                std::exception_ptr error;
+                try {
+                    forkRange<F>(self, body, begin, mid, grain);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                join(self, right);
+                if (error) std::rethrow_exception(error);
+                return;
+            }
+        }
+        body(begin, end);
+    }
+
+    // Thieves take the oldest entry first, so if the newest one is not ours it was stolen and the
+    // deque is empty
+    template <typename F>
+    void join(Worker& self, RangeTask<F>& right) {
+        if (self.deque.pop() == &right) {
+            forkRange<F>(self, *right.body, right.begin, right.end, right.grain);
+            return;
+        }
+        while (!right.done.load(std::memory_order_acquire)) {
+            if (ForkTask* task = steal(self)) execute(task);
+            else std::this_thread::yield();
+        }
+        if (right.error) std::rethrow_exception(right.error);
+    }
+
+    static void execute(ForkTask* task) {
+        try {
+            task->execute(task);
+        } catch (...) {
+            task->error = std::current_exception();
+        }
+        task->done.store(true, std::memory_order_release);
+    }
+
+    ForkTask* steal(Worker& self) {
+        thread_local uint32_t seed = 2463534242u;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        size_t count = numSlots.load(std::memory_order_acquire);
+        size_t start = seed % count;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t k = 0; k < count; ++k) {
+                Worker& victim = slots[(start + k) % count];
+                if (&victim == &self) continue;
+                if (pass == 0 && victim.node.load(std::memory_order_relaxed) != self.node.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                if (ForkTask* task = victim.deque.steal()) return task;
+            }
+        }
+        return nullptr;
+    }
+
+    bool runSubmitted() {
+        if (numSubmitted.load(std::memory_order_relaxed) == 0) return false;
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(submittedMutex);
+            if (submitted.empty()) return false;
+            task = std::move(submitted.front());
+            submitted.pop_front();
+            --numSubmitted;
+        }
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Pool task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Pool task failed" << std::endl;
+        }
+        return true;
+    }
+
+    // Borrows a guest slot for an outside thread, or returns nullptr if all are taken
+    Worker* attach() {
+        for (size_t i = numWorkers; i < numWorkers + MAX_GUESTS; ++i) {
+            bool expected = false;
+            if (!slots[i].inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) continue;
+            slots[i].node = Topology::active().currentNode();
+            size_t count = numSlots.load(std::memory_order_relaxed);
+            while (count < i + 1 && !numSlots.compare_exchange_weak(count, i + 1, std::memory_order_release)) {}
+            return &slots[i];
+        }
+        return nullptr;
+    }
+
+    // Wakes a sleeping worker after new work appeared
+    void signal() {
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    void run(Worker* self) {
+        current() = self;
+        Topology::active().placeThread(true);
+        self->node = Topology::active().currentNode();
+        while (true) {
+            uint64_t seen = epoch.load(std::memory_order_seq_cst);
+            if (runSubmitted()) continue;
+            if (ForkTask* task = steal(*self)) {
+                execute(task);
+                continue;
+            }
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stop) {
+                sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                return;
+            }
+            wake.wait(lock, [this, seen] { return stop || epoch.load(std::memory_order_seq_cst) != seen; });
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    size_t numWorkers;
+    std::unique_ptr<Worker[]> slots;  // Workers first, then guest slots
+    std::atomic<size_t> numSlots;     // Slots thieves look at
+    std::vector<std::thread> threads;
+
+    std::mutex submittedMutex;
+    std::deque<Task> submitted;
+    std::atomic<size_t> numSubmitted{0};
+
+    std::mutex sleepMutex;  // Guards stop; sleeping workers wait on `wake` for `epoch` to move
+    std::condition_variable wake;
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<int> sleepers{0};
+    bool stop = false;
+};
+
+#endif // THREAD_POOL_HPP
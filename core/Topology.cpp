@@ -0,0 +1,193 @@
+#include "Topology.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Parses a sysfs CPU list such as "0-3,8-11"
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::istringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        int first, last;
+        int fields = std::sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (fields < 1) continue;
+        if (fields == 1) last = first;
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+std::string readLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+long setMemPolicy(int mode, const std::vector<unsigned long>& mask) {
+    // maxnode counts one past the highest bit, as the kernel reads maxnode - 1 bits
+    return syscall(SYS_set_mempolicy, mode, mask.empty() ? nullptr : mask.data(),
+                   mask.empty() ? 0 : mask.size() * 8 * sizeof(unsigned long) + 1);
+}
+
+const char* NODE_DIR = "/sys/devices/system/node";
+
+thread_local bool solverThread = false;  // Placed by placeThread(true), so on node-local allocation
+
+} // namespace
+
+Topology::Topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof allowed, &allowed) == -1) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) CPU_SET(cpu, &allowed);
+    }
+
+    std::vector<int> ids;
+    if (DIR* dir = opendir(NODE_DIR)) {
+        while (dirent* entry = readdir(dir)) {
+            int id;
+            char tail;
+            if (std::sscanf(entry->d_name, "node%d%c", &id, &tail) == 1) ids.push_back(id);
+        }
+        closedir(dir);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (int id : ids) {
+        std::vector<int> cpus;
+        for (int cpu : parseCpuList(readLine(std::string(NODE_DIR) + "/node" + std::to_string(id) + "/cpulist"))) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (cpus.empty()) continue;
+        nodeIds.push_back(id);
+        nodeCpus.push_back(std::move(cpus));
+    }
+    // Without NUMA sysfs every allowed CPU counts as node 0
+    if (nodeCpus.empty()) {
+        nodeIds.push_back(0);
+        nodeCpus.emplace_back();
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) nodeCpus[0].push_back(cpu);
+        }
+    }
+
+    for (size_t node = 0; node < nodeCpus.size(); ++node) {
+        for (int cpu : nodeCpus[node]) {
+            if (cpu >= static_cast<int>(cpuNode.size())) cpuNode.resize(cpu + 1, -1);
+            cpuNode[cpu] = static_cast<int>(node);
+        }
+    }
+    size_t widest = 0;
+    for (const std::vector<int>& cpus : nodeCpus) widest = std::max(widest, cpus.size());
+    for (size_t i = 0; i < widest; ++i) {
+        for (const std::vector<int>& cpus : nodeCpus) {
+            if (i < cpus.size()) cpuOrder.push_back(cpus[i]);
+        }
+    }
+}
+
+int Topology::nodeOfCpu(int cpu) const {
+    if (cpu < 0 || cpu >= static_cast<int>(cpuNode.size()) || cpuNode[cpu] < 0) return 0;
+    return cpuNode[cpu];
+}
+
+bool Topology::setPinning(const std::string& mode) {
+    if (mode == "none") pinThreads = false;
+    else if (mode == "cores") pinThreads = true;
+    else return false;
+    return true;
+}
+
+bool Topology::setMemoryPolicy(const std::string& mode) {
+    if (mode == "default") {
+        memory = Memory::FIRST_TOUCH;
+        return true;
+    }
+    if (mode == "interleave") {
+        memory = Memory::INTERLEAVE;
+        return true;
+    }
+    char* end;
+    long node = std::strtol(mode.c_str(), &end, 10);
+    if (mode.empty() || *end != '\0' || std::find(nodeIds.begin(), nodeIds.end(), node) == nodeIds.end()) {
+        return false;
+    }
+    memory = Memory::PREFERRED;
+    preferredNode = static_cast<int>(node);
+    return true;
+}
+
+bool Topology::applyMemoryPolicy() const {
+    if (memory == Memory::FIRST_TOUCH) return true;
+    std::vector<unsigned long> mask;
+    auto add = [&mask](int node) {
+        size_t word = node / (8 * sizeof(unsigned long));
+        if (mask.size() <= word) mask.resize(word + 1, 0);
+        mask[word] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    };
+    if (memory == Memory::INTERLEAVE) {
+        for (int id : nodeIds) add(id);
+    } else {
+        add(preferredNode);
+    }
+    if (setMemPolicy(memory == Memory::INTERLEAVE ? MPOL_INTERLEAVE : MPOL_PREFERRED, mask) == -1) {
+        perror("set_mempolicy");
+        return false;
+    }
+    return true;
+}
+
+void Topology::placeThread(bool solver) {
+    if (pinThreads && !cpuOrder.empty()) {
+        int cpu = cpuOrder[nextSlot++ % cpuOrder.size()];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int rv = pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+        if (rv != 0) std::cerr << "pthread_setaffinity_np: " << std::strerror(rv) << '\n';
+    }
+    if (solver && memory != Memory::FIRST_TOUCH) setMemPolicy(MPOL_DEFAULT, {});
+    solverThread = solver;
+}
+
+Topology::GraphMemory::GraphMemory(bool building)
+    : switched(building && solverThread && active().memory != Memory::FIRST_TOUCH && active().applyMemoryPolicy()) {}
+
+Topology::GraphMemory::~GraphMemory() {
+    if (switched) setMemPolicy(MPOL_DEFAULT, {});
+}
+
+int Topology::currentNode() const {
+    return nodeOfCpu(sched_getcpu());
+}
+
+Topology::NumaCounters Topology::counters() const {
+    NumaCounters total;
+    for (int id : nodeIds) {
+        std::ifstream in(std::string(NODE_DIR) + "/node" + std::to_string(id) + "/numastat");
+        std::string name;
+        uint64_t value;
+        while (in >> name >> value) {
+            if (name == "numa_hit") total.hit += value;
+            else if (name == "numa_miss") total.miss += value;
+            else if (name == "interleave_hit") total.interleave += value;
+            else if (name == "local_node") total.localNode += value;
+            else if (name == "other_node") total.otherNode += value;
+        }
+    }
+    return total;
+}
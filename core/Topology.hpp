@@ -0,0 +1,82 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CPU and NUMA layout of the machine, read once from sysfs, and the thread and memory placement
+// chosen at startup. Pinned threads take CPUs in an order that alternates between nodes, so any
+// group of consecutive threads (an engine's workers, the solver pool) is spread evenly over them.
+//
+// Memory placement is set per thread with set_mempolicy and inherited by threads created later:
+// the policy installed on the main thread before the engines start covers the graph, which is
+// built by engine threads, while solver pool threads allocate on their own node so each one's
+// workspace and share of a parallel loop stay local. A pool worker running a pooled engine's
+// graph-building command switches to the graph policy for that command (GraphMemory).
+class Topology {
+public:
+    // System-wide counters from /sys/devices/system/node/node*/numastat, summed over nodes
+    struct NumaCounters {
+        uint64_t hit = 0;         // Allocated on the node the policy asked for
+        uint64_t miss = 0;        // Asked for another node, which was full
+        uint64_t interleave = 0;  // Interleaved pages that landed on their intended node
+        uint64_t localNode = 0;   // Allocated on the node of the allocating CPU
+        uint64_t otherNode = 0;   // Allocated away from the allocating CPU
+    };
+
+    Topology();
+
+    size_t numNodes() const { return nodeCpus.size(); }
+    size_t numCpus() const { return cpuOrder.size(); }
+    int nodeOfCpu(int cpu) const;
+
+    // "none" or "cores"; false if unknown
+    bool setPinning(const std::string& mode);
+    // "default" (first touch), "interleave", or a node number the graph should prefer
+    bool setMemoryPolicy(const std::string& mode);
+    bool pinning() const { return pinThreads; }
+
+    // Installs the graph memory policy on the calling thread; call before starting the engines
+    bool applyMemoryPolicy() const;
+    // Pins the calling thread to the next CPU when pinning is on. Solver threads also switch to
+    // node-local allocation.
+    void placeThread(bool solver = false);
+    // Node of the CPU the calling thread runs on
+    int currentNode() const;
+
+    NumaCounters counters() const;
+
+    // While alive, a solver thread allocates under the graph memory policy; other threads already
+    // do. Does nothing if `building` is false.
+    class GraphMemory {
+    public:
+        explicit GraphMemory(bool building);
+        ~GraphMemory();
+        GraphMemory(const GraphMemory&) = delete;
+        GraphMemory& operator=(const GraphMemory&) = delete;
+
+    private:
+        bool switched;
+    };
+
+    // Layout used by the server; configured from the command line before any thread is placed
+    static Topology& active() {
+        static Topology topology;
+        return topology;
+    }
+
+private:
+    std::vector<std::vector<int>> nodeCpus;  // Allowed CPUs of every node with any
+    std::vector<int> cpuNode;                // Node of every CPU id, -1 if unknown
+    std::vector<int> cpuOrder;               // Pinning order, alternating between nodes
+    std::vector<int> nodeIds;                // sysfs id of every entry of nodeCpus
+    std::atomic<size_t> nextSlot{0};
+    bool pinThreads = false;
+    enum class Memory { FIRST_TOUCH, INTERLEAVE, PREFERRED } memory = Memory::FIRST_TOUCH;
+    int preferredNode = 0;  // sysfs id, for Memory::PREFERRED
+};
+
+#endif // TOPOLOGY_HPP
@@ -0,0 +1,103 @@
+#include "TreePathIndex.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <limits>
+
+void TreePathIndex::build(const MST& forest, Arena& arena, ThreadPool& pool) {
+    tour.build(forest, arena, pool);
+    n = tour.getNumVertices();
+
+    // Hop counts in tour order, where a parent is always entered before its children
+    hops.assign(n, 0);
+    int height = 0;
+    for (size_t p = 0; p < tour.size(); ++p) {
+        if (!tour.downAt(p)) continue;
+        int child = tour.headAt(p);
+        int parent = tour.headAt(tour.positionOf(tour.twinOf(tour.arcAt(p))));
+        hops[child] = hops[parent] + 1;
+        height = std::max(height, hops[child]);
+    }
+
+    // Only as many levels as the tallest tree needs
+    levels = 1;
+    while ((1 << levels) <= height) ++levels;
+    up.resize(static_cast<size_t>(levels) * n);
+    upWeight.resize(up.size());
+    upChild.resize(up.size());
+
+    pool.parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            int64_t p = tour.firstVisit(static_cast<int>(v));
+            if (p < 0) {
+                up[v] = static_cast<int>(v);
+                upWeight[v] = std::numeric_limits<int>::min();
+                upChild[v] = -1;
+            } else {
+                int arc = tour.arcAt(p);
+                up[v] = tour.headAt(tour.positionOf(tour.twinOf(arc)));
+                upWeight[v] = tour.weightOf(arc);
+                upChild[v] = static_cast<int>(v);
+            }
+        }
+    });
+    for (int k = 1; k < levels; ++k) {
+        const size_t below = static_cast<size_t>(k - 1) * n, here = static_cast<size_t>(k) * n;
+        pool.parallelFor(n, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                int mid = up[below + v];
+                up[here + v] = up[below + mid];
+                bool upper = upWeight[below + mid] > upWeight[below + v];
+                upWeight[here + v] = upper ? upWeight[below + mid] : upWeight[below + v];
+                upChild[here + v] = upper ? upChild[below + mid] : upChild[below + v];
+            }
+        });
+    }
+}
+
+int TreePathIndex::climb(int u, int steps, int& weight, int& child) const {
+    for (int k = 0; steps > 0; ++k, steps >>= 1) {
+        if (!(steps & 1)) continue;
+        size_t at = static_cast<size_t>(k) * n + u;
+        if (upWeight[at] > weight || child == -1) {
+            weight = upWeight[at];
+            child = upChild[at];
+        }
+        u = up[at];
+    }
+    return u;
+}
+
+int TreePathIndex::lowestCommonAncestor(int u, int v) const {
+    if (hops[u] < hops[v]) std::swap(u, v);
+    int weight = 0, child = -1;
+    u = climb(u, hops[u] - hops[v], weight, child);
+    if (u == v) return u;
+    for (int k = levels - 1; k >= 0; --k) {
+        size_t k0 = static_cast<size_t>(k) * n;
+        if (up[k0 + u] != up[k0 + v]) {
+            u = up[k0 + u];
+            v = up[k0 + v];
+        }
+    }
+    return up[u];
+}
+
+int64_t TreePathIndex::depthOf(int v) const {
+    int64_t p = tour.firstVisit(v);
+    return p < 0 ? 0 : tour.depthAt(p);
+}
+
+int64_t TreePathIndex::distance(int u, int v) const {
+    return depthOf(u) + depthOf(v) - 2 * depthOf(lowestCommonAncestor(u, v));
+}
+
+bool TreePathIndex::maxEdge(int u, int v, MSTEdge& edge) const {
+    if (u == v || !connected(u, v)) return false;
+    int ancestor = lowestCommonAncestor(u, v);
+    int weight = 0, child = -1;
+    climb(u, hops[u] - hops[ancestor], weight, child);
+    climb(v, hops[v] - hops[ancestor], weight, child);
+    edge = {child, up[child], weight};
+    return true;
+}
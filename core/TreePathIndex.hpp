@@ -0,0 +1,44 @@
+#ifndef TREE_PATH_INDEX_HPP
+#define TREE_PATH_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EulerTour.hpp"
+#include "MST.hpp"
+
+class Arena;
+class ThreadPool;
+
+// Point queries on the paths of a spanning forest. build() roots every tree at its lowest vertex
+// through an Euler tour and fills binary lifting tables: the 2^k-th ancestor of each vertex and
+// the heaviest edge on the way there. A query lifts both vertices to their lowest common ancestor
+// in O(log h) steps for a tree of height h. Vertices are 0-based.
+class TreePathIndex {
+public:
+    void build(const MST& forest, Arena& arena, ThreadPool& pool);
+
+    int getNumVertices() const { return n; }
+    bool connected(int u, int v) const { return tour.componentOf(u) == tour.componentOf(v); }
+
+    // Sum of edge weights on the path; u and v must be connected
+    int64_t distance(int u, int v) const;
+    // Heaviest edge on the path; false if u and v are not connected or are the same vertex
+    bool maxEdge(int u, int v, MSTEdge& edge) const;
+
+private:
+    // Lifts u by `steps` edges, folding the heaviest edge passed into weight/child
+    int climb(int u, int steps, int& weight, int& child) const;
+    int lowestCommonAncestor(int u, int v) const;
+    int64_t depthOf(int v) const;
+
+    int n = 0;
+    int levels = 0;
+    EulerTour tour;
+    std::vector<int> hops;          // Edges between each vertex and its root
+    std::vector<int> up;            // up[k * n + v]: 2^k-th ancestor of v, or the root
+    std::vector<int> upWeight;      // Heaviest edge weight on that climb
+    std::vector<int> upChild;       // Lower endpoint of that edge, -1 if the climb is empty
+};
+
+#endif // TREE_PATH_INDEX_HPP
@@ -0,0 +1,308 @@
+#ifndef COROUTINE_SESSIONS_HPP
+#define COROUTINE_SESSIONS_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Engine.hpp"
+#include "LineBuffer.hpp"
+#include "ThreadPool.hpp"
+#include "task.hpp"
+
+// Every connection is a coroutine that reads like the blocking engines' handleClient:
+//   while (line = co_await readLine(socket)) {
+//       response = co_await compute(execute(line));
+//       co_await writeAll(socket, response);
+//   }
+// Socket waits suspend on one edge-triggered epoll loop, and commands run on the shared
+// work-stealing scheduler, so a session costs a coroutine frame and its unframed input rather
+// than a thread. Commands in flight beyond the high watermark get the busy response.
+class CoroutineSessions : public Engine {
+public:
+    CoroutineSessions(const Context& ctx)
+        : Engine(ctx), stopping(false), epollFd(-1), wakeFd(-1), admission(ctx.queueLimits) {}
+
+    ~CoroutineSessions() {
+        stop();
+    }
+
+    void start() override {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        fcntl(ctx.listenerSocket, F_SETFL, fcntl(ctx.listenerSocket, F_GETFL) | O_NONBLOCK);
+        watch(wakeFd, EPOLLIN);
+        watch(ctx.listenerSocket, EPOLLIN | EPOLLET);
+        loop = std::thread(&CoroutineSessions::run, this);
+    }
+
+    void stop() override {
+        if (!loop.joinable()) return;
+        stopping = true;
+        wake();
+        loop.join();
+        close(wakeFd);
+        close(epollFd);
+    }
+
+    std::string name() const override { return "coroutine"; }
+
+private:
+    // A non-blocking socket with at most one coroutine waiting to read and one waiting to write.
+    // Wakeups can be spurious, so waiters retry their syscall before suspending again.
+    struct Socket {
+        int fd;
+        std::coroutine_handle<> reader;
+        std::coroutine_handle<> writer;
+        LineBuffer in;  // Bytes not yet framed into a command
+    };
+
+    struct Readiness {
+        std::coroutine_handle<>& waiter;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) noexcept { waiter = handle; }
+        void await_resume() noexcept {}
+    };
+
+    // Executes a command from the shared scheduler and resumes the awaiting session on the loop
+    // thread once it is answered, which for a RunMST attached to a solve in flight, or a command
+    // waiting for the graph lock, is later and from another worker
+    struct Execute {
+        CoroutineSessions* engine;
+        const std::vector<std::string>& command;
+        std::optional<CommandProcessor::Response> result;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            ThreadPool::shared().submit([this, handle] {
+                engine->ctx.processor.executeAsync(command, [this, handle](const CommandProcessor::Response& response) {
+                    result.emplace(response);
+                    engine->post(handle);
+                });
+            });
+        }
+        CommandProcessor::Response await_resume() { return std::move(*result); }
+    };
+
+    void run() {
+        Topology::active().placeThread();
+        acceptor = acceptConnections();
+        acceptor.start();
+
+        // Once stopping, sessions start no new commands; the loop keeps going until every command
+        // already on the scheduler has come back, since those hold pointers into session frames
+        epoll_event events[256];
+        while (!stopping || inFlight > 0) {
+            int n = epoll_wait(epollFd, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                perror("epoll_wait");
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wakeFd) {
+                    uint64_t value;
+                    while (read(wakeFd, &value, sizeof value) > 0) {}
+                    resumeComputed();
+                    continue;
+                }
+                // Resuming a waiter can end its session, so the socket is looked up again each time
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) resumeWaiter(fd, &Socket::reader);
+                if (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) resumeWaiter(fd, &Socket::writer);
+            }
+            reapFinished();
+        }
+
+        // A post() may still be signalling after its session was resumed; wait it out
+        {
+            std::lock_guard<std::mutex> lock(computedMutex);
+        }
+        // Sessions still parked on a socket are dropped; their frames own nothing but the fd
+        for (auto& entry : sockets) {
+            if (entry.first == ctx.listenerSocket) continue;
+            close(entry.first);
+            ctx.stats.connectionClosed();
+        }
+        sockets.clear();
+        sessions.clear();
+        acceptor = Task<>();
+    }
+
+    Task<> acceptConnections() {
+        Socket listener{ctx.listenerSocket, {}, {}, {}};
+        sockets[listener.fd] = &listener;
+        while (!stopping) {
+            sockaddr_storage remoteaddr;
+            socklen_t addrlen = sizeof remoteaddr;
+            int fd = accept4(listener.fd, (struct sockaddr *)&remoteaddr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd == -1) {
+                if (errno == EINTR) continue;
+                // EINVAL: the server shut the listener down and stop() is about to follow
+                if (errno == EINVAL) break;
+                if (errno != EAGAIN && errno != EWOULDBLOCK && !stopping) perror("accept");
+                co_await Readiness{listener.reader};
+                continue;
+            }
+            watch(fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET);
+            ctx.stats.connectionOpened();
+            if (ctx.verbose) std::cout << "New connection accepted\n";
+            uint64_t id = nextSession++;
+            sessions.emplace(id, session(fd, id)).first->second.start();
+        }
+        sockets.erase(listener.fd);
+    }
+
+    Task<> session(int fd, uint64_t id) {
+        Socket socket{fd, {}, {}, {}};
+        sockets[fd] = &socket;
+        while (!stopping) {
+            // The line stays valid until the next readLine(), which is after it has been parsed
+            std::optional<std::string_view> line = co_await readLine(socket);
+            if (!line) break;
+            Instrumentation::Clock::time_point start = Instrumentation::Clock::now();
+            std::vector<std::string> parts = ctx.processor.parse(*line);
+            CommandProcessor::Response response{BUSY_RESPONSE, false};
+            if (!admission.full(inFlight)) {
+                ++inFlight;
+                response = co_await Execute{this, parts, std::nullopt};
+                --inFlight;
+            } else {
+                ctx.stats.busyRejection();
+            }
+            bool sent = co_await writeAll(socket, response);
+            ctx.stats.recordCommand(parts.empty() ? "" : parts[0], start, response.ok);
+            if (ctx.verbose) std::cout << "Client " << fd << " - Sent response: " << response.text;
+            if (!sent) break;
+        }
+        sockets.erase(fd);
+        close(fd);
+        ctx.stats.connectionClosed();
+        finished.push_back(id);
+    }
+
+    // Next command line, or nothing once the peer hung up, sent a line past the maximum length
+    // (answered with the error first) or the engine is stopping
+    Task<std::optional<std::string_view>> readLine(Socket& socket) {
+        while (true) {
+            std::string_view line;
+            if (socket.in.nextLine(line)) co_return line;
+            if (socket.in.overlong()) {
+                ctx.stats.lineTooLong();
+                socket.in.clear();
+                CommandProcessor::Response error{LINE_TOO_LONG_RESPONSE, false};
+                co_await writeAll(socket, error);
+                co_return std::nullopt;
+            }
+            socket.in.trim();
+            ssize_t nbytes = recv(socket.fd, readBuffer, sizeof readBuffer, 0);
+            if (nbytes > 0) {
+                ctx.stats.bytesReceived(nbytes);
+                socket.in.append(readBuffer, nbytes);
+                continue;
+            }
+            if (nbytes == 0) {
+                if (ctx.verbose) std::cout << "Socket " << socket.fd << " hung up\n";
+                co_return std::nullopt;
+            }
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                if (!stopping) perror("recv");
+                co_return std::nullopt;
+            }
+            co_await Readiness{socket.reader};
+            if (stopping) co_return std::nullopt;
+        }
+    }
+
+    // Edge lists go out a chunk per send, so a session never holds more than one chunk of them
+    Task<bool> writeAll(Socket& socket, const CommandProcessor::Response& response) {
+        ResponseCursor cursor(response);
+        ssize_t n;
+        while ((n = cursor.sendTo(socket.fd)) != 0) {
+            if (n > 0) {
+                ctx.stats.bytesSent(n);
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                co_await Readiness{socket.writer};
+            } else if (errno != EINTR) {
+                co_return false;
+            }
+        }
+        co_return true;
+    }
+
+    void resumeWaiter(int fd, std::coroutine_handle<> Socket::*waiter) {
+        auto it = sockets.find(fd);
+        if (it == sockets.end()) return;
+        std::coroutine_handle<> handle = std::exchange(it->second->*waiter, nullptr);
+        if (handle) handle.resume();
+    }
+
+    // Called from scheduler threads once a command's result is stored
+    void post(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(computedMutex);
+        computed.push_back(handle);
+        wake();
+    }
+
+    void resumeComputed() {
+        std::vector<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lock(computedMutex);
+            ready.swap(computed);
+        }
+        for (std::coroutine_handle<> handle : ready) handle.resume();
+    }
+
+    // A finished session is suspended at its end and can only be destroyed from outside it
+    void reapFinished() {
+        for (uint64_t id : finished) sessions.erase(id);
+        finished.clear();
+    }
+
+    void watch(int fd, uint32_t events) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == -1) perror("epoll_ctl");
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof one);
+        (void)ignored;
+    }
+
+    std::atomic<bool> stopping;
+    int epollFd;
+    int wakeFd;
+    std::thread loop;
+
+    // Loop thread only
+    Task<> acceptor;
+    std::unordered_map<uint64_t, Task<>> sessions;
+    std::unordered_map<int, Socket*> sockets;  // Sockets with a live coroutine, by fd
+    std::vector<uint64_t> finished;
+    uint64_t nextSession = 0;
+    Watermark admission;
+    size_t inFlight = 0;  // Commands on the scheduler
+    char readBuffer[65536];
+
+    std::mutex computedMutex;  // Guards computed; held by post() until it has signalled the loop
+    std::vector<std::coroutine_handle<>> computed;
+};
+
+#endif // COROUTINE_SESSIONS_HPP
@@ -12,15 +12,16 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <string>
-#include <sstream>
-#include "Graph.hpp"
-#include "MSTFactory.hpp"
+#include <memory>
+#include "Engine.hpp"
+#include "LineBuffer.hpp"
 
+// One pipeline stage: a thread draining a bounded FIFO of tasks
 class ActiveObject {
 public:
     using Task = std::function<void()>;
 
-    ActiveObject() : stop(false) {
+    explicit ActiveObject(const QueueLimits& limits) : gate(limits), stop(false) {
         worker = std::thread(&ActiveObject::run, this);
     }
 
@@ -30,21 +31,42 @@ public:
             stop = true;
         }
         condition.notify_one();
+        notFull.notify_all();
         if (worker.joinable()) {
             worker.join();
         }
     }
 
-    void enqueue(Task task) {
+    // Blocks while the queue is over its watermark, which stalls the calling stage in turn.
+    // Returns true if it had to wait.
+    bool enqueue(Task task) {
+        bool waited = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (gate.full(tasks.size())) {
+                waited = true;
+                notFull.wait(lock, [this] { return stop || !gate.full(tasks.size()); });
+            }
+            tasks.push(std::move(task));
+        }
+        condition.notify_one();
+        return waited;
+    }
+
+    // Refuses the task instead of waiting while the queue is over its watermark
+    bool tryEnqueue(Task task) {
         {
             std::lock_guard<std::mutex> lock(mutex);
+            if (gate.full(tasks.size())) return false;
             tasks.push(std::move(task));
         }
         condition.notify_one();
+        return true;
     }
 
 private:
     void run() {
+        Topology::active().placeThread();
         while (true) {
             Task task;
             {
@@ -53,127 +75,145 @@ private:
                 if (stop && tasks.empty()) return;
                 task = std::move(tasks.front());
                 tasks.pop();
+                if (!gate.full(tasks.size())) notFull.notify_all();
             }
             task();
         }
     }
 
     std::queue<Task> tasks;
+    Watermark gate;
     std::thread worker;
     std::mutex mutex;
     std::condition_variable condition;
+    std::condition_variable notFull;
     std::atomic<bool> stop;
 };
 
-class Pipeline {
+class Pipeline : public Engine {
 public:
-    Pipeline(int listenerSocket) 
-        : listenerSocket(listenerSocket), 
-          stop(false),
-          acceptor(std::make_unique<ActiveObject>()),
-          parser(std::make_unique<ActiveObject>()),
-          executor(std::make_unique<ActiveObject>()),
-          responder(std::make_unique<ActiveObject>()) {}
+    Pipeline(const Context& ctx)
+        : Engine(ctx),
+          listenerSocket(ctx.listenerSocket), 
+          stopping(false),
+          acceptor(std::make_unique<ActiveObject>(ctx.queueLimits)),
+          parser(std::make_unique<ActiveObject>(ctx.queueLimits)),
+          executor(std::make_unique<ActiveObject>(ctx.queueLimits)),
+          responder(std::make_unique<ActiveObject>(ctx.queueLimits)) {}
 
     ~Pipeline() {
-        stopPipeline();
+        stop();
     }
 
-    void start() {
+    void start() override {
         acceptor->enqueue([this] { acceptConnections(); });
     }
 
-    void stopPipeline() {
-        stop = true;
-        shutdown(listenerSocket, SHUT_RDWR);
-        close(listenerSocket);
+    // Stages drain in pipeline order so queued responses still reach their clients
+    void stop() override {
+        if (stopping.exchange(true)) return;
+        shutdownConnections();
+        acceptor.reset();
+        parser.reset();
+        executor.reset();
+        responder.reset();
     }
 
+    std::string name() const override { return "pipeline"; }
+
 private:
     void acceptConnections() {
-        while (!stop) {
+        while (!stopping) {
             sockaddr_storage remoteaddr;
             socklen_t addrlen = sizeof remoteaddr;
             int clientfd = accept(listenerSocket, (struct sockaddr *)&remoteaddr, &addrlen);
             if (clientfd == -1) {
-                if (errno != EINTR && !stop) {
+                // EINVAL: the server shut the listener down and stop() is about to follow
+                if (errno != EINTR && errno != EINVAL && !stopping) {
                     perror("accept");
                 }
                 continue;
             }
-            std::cout << "New connection accepted\n";
-            parser->enqueue([this, clientfd] { readAndParse(clientfd); });
+            if (!trackConnection(clientfd)) {
+                close(clientfd);
+                continue;
+            }
+            // Connections waiting for the parser are bounded; past the watermark they get the busy
+            // response instead of a place in line
+            ctx.stats.connectionOpened();
+            if (!parser->tryEnqueue([this, clientfd] { readAndParse(clientfd); })) {
+                untrackConnection(clientfd);
+                ctx.stats.connectionClosed();
+                rejectConnection(clientfd);
+                continue;
+            }
+            if (ctx.verbose) std::cout << "New connection accepted\n";
         }
     }
 
     void readAndParse(int clientfd) {
-        char buf[1024];
-        std::string buffer;
-        while (!stop) {
-            int nbytes = recv(clientfd, buf, sizeof buf, 0);
-            if (nbytes <= 0 || stop) {
-                if (nbytes == 0) std::cout << "Socket " << clientfd << " hung up\n";
-                else if (!stop) perror("recv");
+        LineBuffer buffer;
+        while (!stopping) {
+            char* space = buffer.space();
+            ssize_t nbytes = recv(clientfd, space, buffer.spaceSize(), 0);
+            if (nbytes <= 0 || stopping) {
+                if (nbytes == 0 && ctx.verbose) std::cout << "Socket " << clientfd << " hung up\n";
+                else if (nbytes < 0 && !stopping) perror("recv");
                 break;
             }
-            buffer.append(buf, nbytes);
-            size_t pos;
-            while ((pos = buffer.find('\n')) != std::string::npos) {
-                std::string command = buffer.substr(0, pos);
-                buffer.erase(0, pos + 1);
-                std::vector<std::string> parsedCommand = graph.parse(command);
-                executor->enqueue([this, clientfd, parsedCommand] { executeCommand(clientfd, parsedCommand); });
+            ctx.stats.bytesReceived(nbytes);
+            buffer.commit(nbytes);
+            std::string_view command;
+            while (buffer.nextLine(command)) {
+                auto start = Instrumentation::Clock::now();
+                std::vector<std::string> parsedCommand = ctx.processor.parse(command);
+                // A full executor blocks this reader, so the socket stops being read and TCP
+                // flow control pushes back on the client
+                if (executor->enqueue([this, clientfd, parsedCommand, start] { executeCommand(clientfd, parsedCommand, start); })) {
+                    ctx.stats.readPaused();
+                }
             }
-        }
-        close(clientfd);
-    }
-
-    void executeCommand(int clientfd, const std::vector<std::string>& command) {
-        std::string result;
-        {
-            std::lock_guard<std::mutex> lock(graph_mutex);
-            if (command[0] == "RunMST") {
-                result = runMST(command[1]);
-            } else {
-                result = graph.eval(command) ? "Command processed successfully" : "Command processing failed";
+            if (buffer.overlong()) {
+                // Through both stages, so the error follows the responses already queued
+                ctx.stats.lineTooLong();
+                auto start = Instrumentation::Clock::now();
+                executor->enqueue([this, clientfd, start] {
+                    responder->enqueue([this, clientfd, start] {
+                        sendResponse(clientfd, {LINE_TOO_LONG_RESPONSE, false}, "", start);
+                    });
+                });
+                break;
             }
         }
-        responder->enqueue([this, clientfd, result] { sendResponse(clientfd, result); });
+        // The socket is closed by the responder once every queued response has been sent
+        executor->enqueue([this, clientfd] {
+            responder->enqueue([this, clientfd] {
+                untrackConnection(clientfd);
+                ctx.stats.connectionClosed();
+                close(clientfd);
+            });
+        });
     }
 
-    std::string runMST(const std::string& algorithm) {
-        try {
-            auto mstAlgorithm = MSTFactory::createAlgorithm(algorithm);
-            MST mst = mstAlgorithm->solve(graph);
-            mst.calculateDistances();
-
-            std::stringstream ss;
-            ss << "MST Results:\n"
-               << "Total weight: " << mst.getTotalWeight() << "\n"
-               << "Longest distance: " << mst.getLongestDistance() << "\n"
-               << "Average distance: " << mst.getAverageDistance() << "\n"
-               << "Shortest distance: " << mst.getShortestDistance() << "\n";
-            
-            return ss.str();
-        } catch (const std::exception& e) {
-            return std::string("Error running MST algorithm: ") + e.what();
-        }
+    void executeCommand(int clientfd, const std::vector<std::string>& command, Instrumentation::Clock::time_point start) {
+        CommandProcessor::Response response = ctx.processor.execute(command);
+        std::string cmd = command.empty() ? "" : command[0];
+        responder->enqueue([this, clientfd, response, cmd, start] { sendResponse(clientfd, response, cmd, start); });
     }
 
-    void sendResponse(int clientfd, const std::string& result) {
-        std::string response = result + "\n";
-        send(clientfd, response.c_str(), response.length(), 0);
-        std::cout << "Client " << clientfd << " - Sent response: " << response;
+    void sendResponse(int clientfd, const CommandProcessor::Response& response, const std::string& cmd,
+                      Instrumentation::Clock::time_point start) {
+        sendAll(clientfd, response);
+        ctx.stats.recordCommand(cmd, start, response.ok);
+        if (ctx.verbose) std::cout << "Client " << clientfd << " - Sent response: " << response.text;
     }
 
     int listenerSocket;
-    std::atomic<bool> stop;
+    std::atomic<bool> stopping;
     std::unique_ptr<ActiveObject> acceptor;
     std::unique_ptr<ActiveObject> parser;
     std::unique_ptr<ActiveObject> executor;
     std::unique_ptr<ActiveObject> responder;
-    Graph graph;
-    std::mutex graph_mutex;
 };
 
-#endif // PIPELINE_ACTIVE_OBJECT_HPP
\ No newline at end of file
+#endif // PIPELINE_ACTIVE_OBJECT_HPP
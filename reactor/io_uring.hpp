@@ -0,0 +1,333 @@
+#ifndef IO_URING_HPP
+#define IO_URING_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Minimal io_uring wrapper over the raw syscalls (no liburing dependency).
+// Only what the uring reactor needs: one SQ/CQ pair and provided receive buffers.
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring() {
+        if (bufRing) munmap(bufRing, bufRingSize);
+        if (sqes) munmap(sqes, sqesSize);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing) munmap(sqRing, sqRingSize);
+        if (fd != -1) close(fd);
+    }
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool init(unsigned entries) {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof p);
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+        if (fd < 0) {
+            fd = -1;
+            return false;
+        }
+        if (!(p.features & IORING_FEAT_SINGLE_MMAP)) return false;
+
+        sqRingSize = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+        cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            sqRing = nullptr;
+            return false;
+        }
+        cqRing = sqRing;
+
+        sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+        void* s = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (s == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqEntries = p.sq_entries;
+        sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        localTail = *sqTail;
+
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    // Asks the kernel which opcodes this ring accepts with IORING_REGISTER_PROBE, instead of
+    // guessing from the release string; false too on kernels without the probe (before 5.6)
+    bool supports(std::initializer_list<uint8_t> opcodes) const {
+        constexpr unsigned MAX_OPS = 256;
+        std::vector<char> storage(sizeof(io_uring_probe) + MAX_OPS * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, MAX_OPS) != 0) return false;
+        for (uint8_t op : opcodes) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+        }
+        return true;
+    }
+
+    // Multishot recv is a flag, not an opcode, so the probe cannot see it: receives one byte over
+    // a socketpair and checks the kernel (6.0 or later) keeps the request armed. Multishot accept
+    // is older (5.19), so this covers it too. Call after setupProvidedBuffers, on an idle ring.
+    bool multishotRecvWorks() {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) return false;
+        bool works = false;
+        io_uring_sqe* sqe = getSqe();
+        if (sqe && write(sv[1], "x", 1) == 1) {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = sv[0];
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = bufGroup;
+            sqe->user_data = PROBE_USER_DATA;
+            // The peer's shutdown ends the request with a final completion that lacks F_MORE
+            bool armed = submit(1) >= 0;
+            bool more = armed;
+            armed = armed && shutdown(sv[1], SHUT_WR) == 0;
+            while (armed && more) {
+                forEachCqe([this, &works, &more](const io_uring_cqe& cqe) {
+                    if (cqe.user_data != PROBE_USER_DATA) return;
+                    more = cqe.flags & IORING_CQE_F_MORE;
+                    if (cqe.res > 0) {
+                        works = more;
+                        recycleBuffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                    }
+                });
+                if (more && submit(1) < 0) break;
+            }
+        }
+        close(sv[0]);
+        close(sv[1]);
+        return works;
+    }
+
+    // Free SQ entries, submitting queued ones first if there are none
+    unsigned sqSpace() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (localTail - head >= sqEntries) {
+            submit(0);
+            head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        }
+        return sqEntries - (localTail - head);
+    }
+
+    // Returns a zeroed SQE, submitting queued ones first if the ring is full. nullptr if the
+    // kernel takes none of them (it returns EBUSY while its completion queue overflows), in which
+    // case the caller retries once completions have been reaped.
+    io_uring_sqe* getSqe() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (localTail - head >= sqEntries) {
+            submit(0);
+            head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            if (localTail - head >= sqEntries) return nullptr;
+        }
+        unsigned index = localTail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof *sqe);
+        sqArray[index] = index;
+        ++localTail;
+        return sqe;
+    }
+
+    // Publishes queued SQEs and optionally waits for completions, in one syscall
+    int submit(unsigned waitFor) {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        unsigned toSubmit = localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+        if (toSubmit == 0 && waitFor == 0) return 0;
+        int ret;
+        do {
+            ret = static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, waitFor, flags, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+        return ret;
+    }
+
+    template <typename F>
+    void forEachCqe(F&& f) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            f(cqes[head & cqMask]);
+            ++head;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // Provides `count` (a power of two) receive buffers of `size` bytes for IOSQE_BUFFER_SELECT.
+    // Prefers a registered buffer ring; if the kernel accepts the ring but cannot select from it,
+    // falls back to IORING_OP_PROVIDE_BUFFERS, which multishot recv also accepts.
+    bool setupProvidedBuffers(uint16_t group, unsigned count, unsigned size) {
+        bufGroup = group;
+        bufCount = count;
+        bufSize = size;
+        bufMemory.reset(new char[static_cast<size_t>(count) * size]);
+
+        if (setupBufferRing() && bufferRingWorks()) return true;
+        teardownBufferRing();
+
+        io_uring_sqe* sqe = getSqe();
+        if (!sqe) return false;
+        prepareProvide(sqe, 0, count);
+        if (submit(1) < 0) return false;
+        bool ok = false;
+        forEachCqe([&ok](const io_uring_cqe& cqe) { ok = cqe.res >= 0; });
+        return ok;
+    }
+
+    const char* buffer(uint16_t bid) const { return bufMemory.get() + static_cast<size_t>(bid) * bufSize; }
+    uint16_t bufferGroup() const { return bufGroup; }
+    bool usesBufferRing() const { return bufRing != nullptr; }
+
+    // Hands a consumed buffer back to the kernel. In fallback mode this queues an SQE
+    // (user_data 0) that goes out with the next submit, or, with the ring full, waits for
+    // reprovide().
+    void recycleBuffer(uint16_t bid) {
+        if (bufRing) {
+            provideBuffer(bid, 0);
+            commitBuffers(1);
+        } else if (io_uring_sqe* sqe = unprovided.empty() ? getSqe() : nullptr) {
+            prepareProvide(sqe, bid, 1);
+        } else {
+            unprovided.push_back(bid);
+        }
+    }
+
+    // Queues the buffers recycleBuffer could not, as far as the ring has room
+    void reprovide() {
+        while (!unprovided.empty()) {
+            io_uring_sqe* sqe = getSqe();
+            if (!sqe) return;
+            prepareProvide(sqe, unprovided.back(), 1);
+            unprovided.pop_back();
+        }
+    }
+
+    int ringFd() const { return fd; }
+
+private:
+    static constexpr uint64_t PROBE_USER_DATA = ~uint64_t(0);
+
+    bool setupBufferRing() {
+        bufRingSize = bufCount * sizeof(io_uring_buf);
+        void* r = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (r == MAP_FAILED) return false;
+        bufRing = static_cast<io_uring_buf_ring*>(r);
+
+        io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof reg);
+        reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+        reg.ring_entries = bufCount;
+        reg.bgid = bufGroup;
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) return false;
+        bufRingRegistered = true;
+
+        for (unsigned bid = 0; bid < bufCount; ++bid) {
+            provideBuffer(static_cast<uint16_t>(bid), bid);
+        }
+        commitBuffers(bufCount);
+        return true;
+    }
+
+    // Receives one byte over a socketpair to check that the kernel really selects from the ring
+    bool bufferRingWorks() {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) return false;
+        bool works = false;
+        io_uring_sqe* sqe = getSqe();
+        if (sqe && write(sv[1], "x", 1) == 1) {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = sv[0];
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = bufGroup;
+            if (submit(1) >= 0) {
+                forEachCqe([this, &works](const io_uring_cqe& cqe) {
+                    works = cqe.res > 0;
+                    if (works) recycleBuffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+                });
+            }
+        }
+        close(sv[0]);
+        close(sv[1]);
+        return works;
+    }
+
+    void teardownBufferRing() {
+        if (bufRingRegistered) {
+            io_uring_buf_reg reg;
+            std::memset(&reg, 0, sizeof reg);
+            reg.bgid = bufGroup;
+            syscall(__NR_io_uring_register, fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+            bufRingRegistered = false;
+        }
+        if (bufRing) {
+            munmap(bufRing, bufRingSize);
+            bufRing = nullptr;
+        }
+        bufTail = 0;
+    }
+
+    void prepareProvide(io_uring_sqe* sqe, uint16_t firstBid, unsigned count) {
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = static_cast<int>(count);
+        sqe->addr = reinterpret_cast<uint64_t>(buffer(firstBid));
+        sqe->len = bufSize;
+        sqe->buf_group = bufGroup;
+        sqe->off = firstBid;
+        sqe->user_data = 0;
+    }
+
+    void provideBuffer(uint16_t bid, unsigned offset) {
+        io_uring_buf& b = bufRing->bufs[(bufTail + offset) & (bufCount - 1)];
+        b.addr = reinterpret_cast<uint64_t>(buffer(bid));
+        b.len = bufSize;
+        b.bid = bid;
+    }
+
+    void commitBuffers(unsigned count) {
+        bufTail += count;
+        __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+    }
+
+    int fd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0, sqEntries = 0, localTail = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    io_uring_buf_ring* bufRing = nullptr;
+    size_t bufRingSize = 0;
+    bool bufRingRegistered = false;
+    std::unique_ptr<char[]> bufMemory;
+    std::vector<uint16_t> unprovided;  // Fallback mode: consumed buffers waiting for an SQE
+    uint16_t bufGroup = 0, bufTail = 0;
+    unsigned bufCount = 0, bufSize = 0;
+};
+
+#endif // IO_URING_HPP
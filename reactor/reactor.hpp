@@ -0,0 +1,426 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include "Engine.hpp"
+#include "LineBuffer.hpp"
+#include "ThreadPool.hpp"
+
+// Bounded admission of the pooled reactors' commands onto the shared work-stealing scheduler, so
+// commands and the parallel solves they start run on the same threads. A task is handed a
+// `finished` callback and stays admitted until it calls it, which a command answered
+// asynchronously does from whichever worker completes it, after the task itself has returned.
+class WorkerPool {
+public:
+    using Task = std::function<void(std::function<void()> finished)>;
+
+    explicit WorkerPool(const QueueLimits& limits) : gate(limits), outstanding(0) {}
+
+    // Admitted tasks call back into the engine, so they must all finish first
+    ~WorkerPool() {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this] { return outstanding == 0; });
+    }
+
+    // Refuses the task while admitted tasks are over the watermark; the event loop must never block
+    bool tryEnqueue(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (gate.full(outstanding)) return false;
+            ++outstanding;
+        }
+        ThreadPool::shared().submit([this, task = std::move(task)] { task([this] { finish(); }); });
+        return true;
+    }
+
+private:
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--outstanding == 0) drained.notify_all();
+    }
+
+    Watermark gate;
+    std::mutex mutex;
+    std::condition_variable drained;
+    size_t outstanding;  // Admitted and not yet finished
+};
+
+// A framed command line waiting to be executed
+struct ReactorCommand {
+    std::string line;
+    Instrumentation::Clock::time_point start;
+    bool tooLong = false;  // Stands for a line past the maximum: answered, not executed
+};
+
+// Unsent response bytes of one connection at which the reactors stop reading it and running its
+// commands, and at which they start again. Queued edge lists count the memory their cursors hold.
+inline constexpr QueueLimits OUTPUT_LIMITS{size_t(4) << 20, size_t(1) << 20};
+
+// Name a rejected command is recorded under
+inline std::string commandName(const std::string& line) {
+    size_t begin = line.find_first_not_of(' ');
+    if (begin == std::string::npos) return "";
+    return line.substr(begin, line.find(' ', begin) - begin);
+}
+
+// A command executed on a worker, handed back to the event loop for sending
+struct ReactorCompletion {
+    int fd;
+    CommandProcessor::Response response;
+    std::string cmd;
+    Instrumentation::Clock::time_point start;
+};
+
+// Single epoll event loop over non-blocking sockets.
+//   reactor      - commands run inline on the loop thread
+//   reactor-pool - the loop only does I/O; commands run on the shared scheduler, one at a time per
+//                  connection so responses keep request order. A connection whose queue of
+//                  framed commands reaches the high watermark is not read again until it drains
+//                  to the low one, and commands the backed-up pool cannot take get the busy response.
+// In both modes a connection whose unsent output reaches OUTPUT_LIMITS.high is neither read nor
+// has its commands run until the socket has taken it down to the low watermark, so a client that
+// pipelines without reading cannot grow the server's buffers.
+class Reactor : public Engine {
+public:
+    Reactor(const Context& ctx, bool pooled)
+        : Engine(ctx), pooled(pooled), stopping(false), epollFd(-1), wakeFd(-1) {}
+
+    ~Reactor() {
+        stop();
+    }
+
+    void start() override {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        fcntl(ctx.listenerSocket, F_SETFL, fcntl(ctx.listenerSocket, F_GETFL) | O_NONBLOCK);
+        watch(ctx.listenerSocket, EPOLLIN, EPOLL_CTL_ADD);
+        watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+
+        if (pooled) {
+            pool = std::make_unique<WorkerPool>(ctx.queueLimits);
+        }
+        loop = std::thread(&Reactor::run, this);
+    }
+
+    void stop() override {
+        if (!loop.joinable()) return;
+        stopping = true;
+        wake();
+        loop.join();
+        pool.reset();
+        for (auto& entry : connections) {
+            ctx.stats.connectionClosed();
+            close(entry.first);
+        }
+        connections.clear();
+        close(wakeFd);
+        close(epollFd);
+    }
+
+    std::string name() const override { return pooled ? "reactor-pool" : "reactor"; }
+
+private:
+    struct Connection {
+        explicit Connection(const QueueLimits& limits) : backlog(limits), output(OUTPUT_LIMITS) {}
+
+        int fd;
+        LineBuffer in;                // Bytes not yet framed into a command
+        std::string out;              // Response bytes not yet accepted by the socket
+        std::deque<ResponseCursor> streams;  // Responses from the first edge list on, sent after `out`
+        size_t streamBytes = 0;       // Memory held by `streams`
+        std::deque<ReactorCommand> pending;  // Framed commands waiting for a worker (pooled mode)
+        bool busy = false;            // A command of this connection is on a worker
+        bool hungUp = false;          // Peer closed; close once everything is answered
+        Watermark backlog;            // Limits on `pending`
+        bool readPaused = false;      // `pending` is full; the socket is left unread
+        Watermark output;             // Limits on `out` and `streams`
+        bool outputPaused = false;    // Unsent output is full; no reads, and no commands started
+        uint32_t armed = EPOLLIN | EPOLLRDHUP;  // Events currently registered with epoll
+    };
+
+    void run() {
+        Topology::active().placeThread();
+        epoll_event events[256];
+        while (!stopping) {
+            int n = epoll_wait(epollFd, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                perror("epoll_wait");
+                return;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == ctx.listenerSocket) {
+                    acceptAll();
+                } else if (fd == wakeFd) {
+                    uint64_t value;
+                    while (read(wakeFd, &value, sizeof value) > 0) {}
+                    drainCompletions();
+                } else {
+                    auto it = connections.find(fd);
+                    if (it == connections.end()) continue;
+                    Connection& conn = *it->second;
+                    if (events[i].events & EPOLLOUT) {
+                        flush(conn);
+                        if (conn.outputPaused) resume(conn);
+                    }
+                    if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) onReadable(conn);
+                    closeIfDone(conn);
+                }
+            }
+        }
+    }
+
+    void acceptAll() {
+        while (true) {
+            sockaddr_storage remoteaddr;
+            socklen_t addrlen = sizeof remoteaddr;
+            int fd = accept4(ctx.listenerSocket, (struct sockaddr *)&remoteaddr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd == -1) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != EINVAL && !stopping) perror("accept");
+                return;
+            }
+            auto conn = std::make_unique<Connection>(ctx.queueLimits);
+            conn->fd = fd;
+            connections[fd] = std::move(conn);
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+            ctx.stats.connectionOpened();
+            if (ctx.verbose) std::cout << "New connection accepted\n";
+        }
+    }
+
+    void onReadable(Connection& conn) {
+        char buf[65536];
+        while (!conn.hungUp && !conn.readPaused && !conn.outputPaused) {
+            ssize_t nbytes = recv(conn.fd, buf, sizeof buf, 0);
+            if (nbytes < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (!stopping) perror("recv");
+                conn.hungUp = true;
+            } else if (nbytes == 0) {
+                if (ctx.verbose) std::cout << "Socket " << conn.fd << " hung up\n";
+                conn.hungUp = true;
+            } else {
+                ctx.stats.bytesReceived(nbytes);
+                conn.in.append(buf, nbytes);
+                frame(conn);
+            }
+        }
+        if (pooled) dispatch(conn);
+        rearm(conn);
+    }
+
+    // Inline commands stop while the output is full and the rest stay in `in` until it drains
+    void frame(Connection& conn) {
+        std::string_view line;
+        while ((pooled || outputRoom(conn)) && conn.in.nextLine(line)) {
+            if (pooled) {
+                conn.pending.push_back(ReactorCommand{std::string(line), Instrumentation::Clock::now()});
+            } else {
+                Instrumentation::Clock::time_point start = Instrumentation::Clock::now();
+                std::vector<std::string> parts = ctx.processor.parse(line);
+                CommandProcessor::Response response = ctx.processor.execute(parts);
+                respond(conn, response, parts.empty() ? "" : parts[0], start);
+            }
+        }
+        if (conn.in.overlong()) rejectLine(conn);
+        conn.in.trim();
+        if (pooled && !conn.readPaused && conn.backlog.full(conn.pending.size())) {
+            conn.readPaused = true;
+            ctx.stats.readPaused();
+        }
+    }
+
+    // The error goes out after the responses to the lines before it, then the connection closes
+    void rejectLine(Connection& conn) {
+        ctx.stats.lineTooLong();
+        conn.in.clear();
+        conn.hungUp = true;
+        if (pooled) conn.pending.push_back(ReactorCommand{"", Instrumentation::Clock::now(), true});
+        else respond(conn, {LINE_TOO_LONG_RESPONSE, false}, "", Instrumentation::Clock::now());
+    }
+
+    // Runs the lines held back while the output was full, once the socket has taken enough of it
+    void resume(Connection& conn) {
+        frame(conn);
+        if (pooled) dispatch(conn);
+        rearm(conn);
+    }
+
+    // Whether the connection's unsent output leaves room to run another of its commands
+    bool outputRoom(Connection& conn) {
+        bool full = conn.output.full(conn.out.size() + conn.streamBytes);
+        if (full && !conn.outputPaused) ctx.stats.readPaused();
+        conn.outputPaused = full;
+        return !full;
+    }
+
+    void dispatch(Connection& conn) {
+        while (!conn.busy && !conn.pending.empty() && outputRoom(conn)) {
+            ReactorCommand command = std::move(conn.pending.front());
+            conn.pending.pop_front();
+            if (command.tooLong) {
+                respond(conn, {LINE_TOO_LONG_RESPONSE, false}, "", command.start);
+                continue;
+            }
+            int fd = conn.fd;
+            std::string line = command.line;
+            Instrumentation::Clock::time_point start = command.start;
+            conn.busy = pool->tryEnqueue([this, fd, command](std::function<void()> finished) {
+                std::vector<std::string> parts = ctx.processor.parse(command.line);
+                std::string cmd = parts.empty() ? "" : parts[0];
+                ctx.processor.executeAsync(parts, [this, fd, cmd, start = command.start, finished](const CommandProcessor::Response& response) {
+                    {
+                        std::lock_guard<std::mutex> lock(completionsMutex);
+                        completions.push_back(ReactorCompletion{fd, response, cmd, start});
+                    }
+                    wake();
+                    finished();
+                });
+            });
+            // Nothing of this connection is in flight, so answering now keeps response order
+            if (!conn.busy) {
+                ctx.stats.busyRejection();
+                respond(conn, {BUSY_RESPONSE, false}, commandName(line), start);
+            }
+        }
+        if (conn.readPaused && !conn.backlog.full(conn.pending.size())) conn.readPaused = false;
+        rearm(conn);
+    }
+
+    void drainCompletions() {
+        std::vector<ReactorCompletion> done;
+        {
+            std::lock_guard<std::mutex> lock(completionsMutex);
+            done.swap(completions);
+        }
+        for (ReactorCompletion& c : done) {
+            // Connections are kept open while busy, so the lookup cannot miss
+            Connection& conn = *connections.at(c.fd);
+            conn.busy = false;
+            respond(conn, c.response, c.cmd, c.start);
+            dispatch(conn);
+            closeIfDone(conn);
+        }
+    }
+
+    void respond(Connection& conn, const CommandProcessor::Response& response, const std::string& cmd,
+                 Instrumentation::Clock::time_point start) {
+        // Once an edge list is queued, later responses line up behind it to keep their order
+        if (response.edges || !conn.streams.empty()) {
+            conn.streams.emplace_back(response);
+            conn.streamBytes += conn.streams.back().held();
+        } else {
+            conn.out += response.text;
+        }
+        flush(conn);
+        ctx.stats.recordCommand(cmd, start, response.ok);
+        if (ctx.verbose) std::cout << "Client " << conn.fd << " - Sent response: " << response.text;
+    }
+
+    void flush(Connection& conn) {
+        size_t off = 0;
+        bool blocked = false;
+        while (off < conn.out.size()) {
+            ssize_t n = send(conn.fd, conn.out.data() + off, conn.out.size() - off, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    dropOutput(conn);
+                    off = 0;
+                }
+                blocked = true;
+                break;
+            }
+            off += n;
+        }
+        ctx.stats.bytesSent(off);
+        conn.out.erase(0, off);
+        while (!blocked && !conn.streams.empty()) {
+            ssize_t n = conn.streams.front().sendTo(conn.fd);
+            if (n == 0) {
+                conn.streamBytes -= conn.streams.front().held();
+                conn.streams.pop_front();
+            } else if (n > 0) {
+                ctx.stats.bytesSent(n);
+            } else if (errno != EINTR) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) dropOutput(conn);
+                blocked = true;
+            }
+        }
+        rearm(conn);
+    }
+
+    void dropOutput(Connection& conn) {
+        conn.hungUp = true;
+        conn.in.clear();
+        conn.out.clear();
+        conn.streams.clear();
+        conn.streamBytes = 0;
+    }
+
+    static bool hasOutput(const Connection& conn) {
+        return !conn.out.empty() || !conn.streams.empty();
+    }
+
+    // Level-triggered epoll: stop reading after hang-up or while paused, and only ask for EPOLLOUT while output is queued
+    void rearm(Connection& conn) {
+        bool reading = !conn.hungUp && !conn.readPaused && !conn.outputPaused;
+        uint32_t events = (reading ? uint32_t(EPOLLIN | EPOLLRDHUP) : 0u) | (hasOutput(conn) ? uint32_t(EPOLLOUT) : 0u);
+        if (events != conn.armed) {
+            conn.armed = events;
+            watch(conn.fd, events, EPOLL_CTL_MOD);
+        }
+    }
+
+    void closeIfDone(Connection& conn) {
+        if (!conn.hungUp || conn.busy || !conn.pending.empty() || hasOutput(conn)) return;
+        int fd = conn.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+        ctx.stats.connectionClosed();
+    }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, op, fd, &ev) == -1) perror("epoll_ctl");
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof one);
+        (void)ignored;
+    }
+
+    bool pooled;
+    std::atomic<bool> stopping;
+    int epollFd;
+    int wakeFd;
+    std::thread loop;
+    std::unique_ptr<WorkerPool> pool;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<ReactorCompletion> completions;
+    std::mutex completionsMutex;
+};
+
+#endif // REACTOR_HPP
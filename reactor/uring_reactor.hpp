@@ -0,0 +1,535 @@
+#ifndef URING_REACTOR_HPP
+#define URING_REACTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Engine.hpp"
+#include "LineBuffer.hpp"
+#include "io_uring.hpp"
+#include "reactor.hpp"
+
+// io_uring variant of the reactor. One ring per engine:
+//   - a single multishot accept stays armed on the listener
+//   - each connection has one multishot recv drawing from provided buffers (a buffer ring
+//     where the kernel supports it)
+//   - queued responses of a connection go out as one chain of IOSQE_IO_LINK'ed sends
+// In steady state the loop makes one io_uring_enter per batch of completions instead of
+// one accept/recv/send syscall per event. Command execution mirrors Reactor: inline for
+// "uring", on the shared scheduler for "uring-pool", where a connection with a full queue of framed
+// commands has its recv cancelled until the queue drains. As there, a connection whose unsent
+// output reaches OUTPUT_LIMITS.high has its recv cancelled and runs no more commands until its
+// sends bring it down to the low watermark.
+//
+// The kernel stops taking SQEs while its completion queue overflows. Requests that find the ring
+// full then wait in `deferred`, and send chains for `flushLater`, until the loop has reaped
+// completions; a chain is only started when the ring has room for all of it, so its links never
+// straddle a submit.
+class UringReactor : public Engine {
+public:
+    static constexpr unsigned RING_ENTRIES = 4096;
+    static constexpr unsigned RECV_BUFFERS = 1024;   // Power of two, required by the buffer ring
+    static constexpr unsigned RECV_BUFFER_SIZE = 16384;
+    static constexpr uint16_t RECV_GROUP = 0;
+    static constexpr size_t STREAM_CHUNKS = 4;       // Edge list chunks submitted per send chain
+
+    UringReactor(const Context& ctx, bool pooled)
+        : Engine(ctx), pooled(pooled), stopping(false), wakeFd(-1), wakeValue(0) {}
+
+    ~UringReactor() {
+        stop();
+    }
+
+    // Sets up the ring; false means the kernel lacks a required feature and epoll should be used
+    bool init() {
+        if (!ring.init(RING_ENTRIES)) return false;
+        if (!ring.supports({IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_READ,
+                            IORING_OP_ASYNC_CANCEL, IORING_OP_PROVIDE_BUFFERS})) {
+            return false;
+        }
+        if (!ring.setupProvidedBuffers(RECV_GROUP, RECV_BUFFERS, RECV_BUFFER_SIZE)) return false;
+        if (!ring.multishotRecvWorks()) return false;
+        wakeFd = eventfd(0, EFD_CLOEXEC);
+        return wakeFd != -1;
+    }
+
+    void start() override {
+        if (pooled) {
+            pool = std::make_unique<WorkerPool>(ctx.queueLimits);
+        }
+        armAccept();
+        armWake();
+        loop = std::thread(&UringReactor::run, this);
+    }
+
+    void stop() override {
+        if (!loop.joinable()) return;
+        stopping = true;
+        signalWake();
+        loop.join();
+        pool.reset();
+        for (auto& entry : connections) {
+            ctx.stats.connectionClosed();
+            close(entry.first);
+        }
+        connections.clear();
+        close(wakeFd);
+    }
+
+    std::string name() const override { return pooled ? "uring-pool" : "uring"; }
+
+private:
+    enum Op : uint64_t { OP_NONE = 0, OP_ACCEPT, OP_RECV, OP_SEND, OP_WAKE };
+
+    static uint64_t tag(Op op, int fd) { return (static_cast<uint64_t>(op) << 32) | static_cast<uint32_t>(fd); }
+    static Op opOf(uint64_t userData) { return static_cast<Op>(userData >> 32); }
+    static int fdOf(uint64_t userData) { return static_cast<int>(userData & 0xffffffffu); }
+
+    struct Connection {
+        explicit Connection(const QueueLimits& limits) : backlog(limits), output(OUTPUT_LIMITS) {}
+
+        int fd;
+        LineBuffer in;                      // Bytes not yet framed into a command
+        std::deque<ReactorCommand> pending; // Framed commands waiting for a worker (pooled mode)
+        std::deque<std::string> queued;     // Responses not yet submitted
+        std::deque<ResponseCursor> streams; // Responses from the first edge list on, cut into `queued` chunk by chunk
+        std::deque<std::string> inFlight;   // Responses in the current linked send chain
+        std::deque<std::string> retry;      // Unsent tails of a chain broken by a short send
+        size_t unsent = 0;                  // Bytes of queued, inFlight and retry, and memory held by streams
+        unsigned sendsOutstanding = 0;
+        bool busy = false;                  // A command of this connection is on a worker
+        bool hungUp = false;                // Peer closed; close once everything is answered
+        bool broken = false;                // I/O error; drop unsent output and close
+        bool recvArmed = false;
+        Watermark backlog;                  // Limits on `pending`
+        bool readPaused = false;            // `pending` is full; recv is cancelled
+        Watermark output;                   // Limits on `unsent`
+        bool outputPaused = false;          // Unsent output is full; recv is cancelled, no commands started
+    };
+
+    void run() {
+        Topology::active().placeThread();
+        while (!stopping) {
+            int ret = ring.submit(1);
+            if (ret < 0 && errno != EBUSY && errno != EAGAIN) {
+                perror("io_uring_enter");
+                return;
+            }
+            ring.forEachCqe([this](const io_uring_cqe& cqe) { onCompletion(cqe); });
+            retryDeferred();
+        }
+    }
+
+    // Gets an SQE for prepare, or queues prepare behind earlier requests that found the ring full
+    void queueSqe(std::function<void(io_uring_sqe*)> prepare) {
+        if (deferred.empty()) {
+            if (io_uring_sqe* sqe = ring.getSqe()) {
+                prepare(sqe);
+                return;
+            }
+        }
+        deferred.push_back(std::move(prepare));
+    }
+
+    void retryDeferred() {
+        ring.reprovide();
+        while (!deferred.empty()) {
+            io_uring_sqe* sqe = ring.getSqe();
+            if (!sqe) return;
+            deferred.front()(sqe);
+            deferred.pop_front();
+        }
+        std::vector<int> fds;
+        fds.swap(flushLater);
+        for (int fd : fds) {
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            flush(*it->second);
+            closeIfDone(*it->second);
+        }
+    }
+
+    void onCompletion(const io_uring_cqe& cqe) {
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+        switch (opOf(cqe.user_data)) {
+        case OP_ACCEPT:
+            if (cqe.res >= 0) {
+                onAccept(cqe.res);
+            } else if (cqe.res != -EINVAL && !stopping) {
+                std::cerr << "accept: " << strerror(-cqe.res) << '\n';
+            }
+            // EINVAL means the listener was shut down; other hard errors would spin if re-armed
+            if (!more && !stopping && (cqe.res >= 0 || cqe.res == -ECONNABORTED || cqe.res == -EINTR)) armAccept();
+            break;
+        case OP_RECV:
+            onRecv(cqe, more);
+            break;
+        case OP_SEND:
+            onSend(fdOf(cqe.user_data), cqe.res);
+            break;
+        case OP_WAKE:
+            drainCompletions();
+            if (!stopping) armWake();
+            break;
+        default:
+            // Buffer re-provisioning in fallback mode
+            break;
+        }
+    }
+
+    void armAccept() {
+        int listener = ctx.listenerSocket;
+        queueSqe([listener](io_uring_sqe* sqe) {
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = listener;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            sqe->user_data = tag(OP_ACCEPT, listener);
+        });
+    }
+
+    void armWake() {
+        queueSqe([this](io_uring_sqe* sqe) {
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = wakeFd;
+            sqe->addr = reinterpret_cast<uint64_t>(&wakeValue);
+            sqe->len = sizeof wakeValue;
+            sqe->user_data = tag(OP_WAKE, wakeFd);
+        });
+    }
+
+    // Counts as armed while deferred, so the connection is not closed under the request
+    void armRecv(Connection& conn) {
+        int fd = conn.fd;
+        uint16_t group = ring.bufferGroup();
+        queueSqe([fd, group](io_uring_sqe* sqe) {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = fd;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = group;
+            sqe->user_data = tag(OP_RECV, fd);
+        });
+        conn.recvArmed = true;
+    }
+
+    void signalWake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof one);
+        (void)ignored;
+    }
+
+    void onAccept(int fd) {
+        auto conn = std::make_unique<Connection>(ctx.queueLimits);
+        conn->fd = fd;
+        armRecv(*conn);
+        connections[fd] = std::move(conn);
+        ctx.stats.connectionOpened();
+        if (ctx.verbose) std::cout << "New connection accepted\n";
+    }
+
+    void onRecv(const io_uring_cqe& cqe, bool more) {
+        auto it = connections.find(fdOf(cqe.user_data));
+        if (it == connections.end()) return;
+        Connection& conn = *it->second;
+        if (!more) conn.recvArmed = false;
+
+        if (cqe.res > 0) {
+            uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            // Bytes still in flight when the connection was closed for an overlong line are dropped
+            if (!conn.hungUp) conn.in.append(ring.buffer(bid), cqe.res);
+            ring.recycleBuffer(bid);
+            ctx.stats.bytesReceived(cqe.res);
+            if (!conn.hungUp) frame(conn);
+        } else if (cqe.res == 0) {
+            if (ctx.verbose) std::cout << "Socket " << conn.fd << " hung up\n";
+            conn.hungUp = true;
+        } else if (cqe.res != -ENOBUFS && cqe.res != -ECANCELED) {
+            if (!stopping) std::cerr << "recv: " << strerror(-cqe.res) << '\n';
+            markBroken(conn);
+        }
+
+        // Multishot recv stops on ENOBUFS or when the kernel decides to; re-arm unless closing
+        // or paused
+        if (!conn.recvArmed && reading(conn)) armRecv(conn);
+        closeIfDone(conn);
+    }
+
+    void frame(Connection& conn) {
+        splitLines(conn);
+        if (pooled) dispatch(conn);
+        flush(conn);
+    }
+
+    bool reading(const Connection& conn) const {
+        return !conn.hungUp && !conn.readPaused && !conn.outputPaused && !stopping;
+    }
+
+    // Completions already queued when recv is cancelled can hold many more lines, so a paused
+    // connection leaves them in `in` until the backlog or its output drains
+    void splitLines(Connection& conn) {
+        std::string_view line;
+        while (!conn.readPaused && (pooled || outputRoom(conn)) && conn.in.nextLine(line)) {
+            if (!pooled) {
+                Instrumentation::Clock::time_point start = Instrumentation::Clock::now();
+                std::vector<std::string> parts = ctx.processor.parse(line);
+                CommandProcessor::Response response = ctx.processor.execute(parts);
+                respond(conn, response, parts.empty() ? "" : parts[0], start);
+                continue;
+            }
+            conn.pending.push_back(ReactorCommand{std::string(line), Instrumentation::Clock::now()});
+            if (conn.backlog.full(conn.pending.size())) {
+                conn.readPaused = true;
+                ctx.stats.readPaused();
+                if (conn.recvArmed) cancelRecv(conn);
+            }
+        }
+        if (conn.in.overlong()) rejectLine(conn);
+        conn.in.trim();
+    }
+
+    // The error goes out after the responses to the lines before it, then the connection closes
+    void rejectLine(Connection& conn) {
+        ctx.stats.lineTooLong();
+        conn.in.clear();
+        conn.hungUp = true;
+        if (conn.recvArmed) cancelRecv(conn);
+        if (pooled) conn.pending.push_back(ReactorCommand{"", Instrumentation::Clock::now(), true});
+        else respond(conn, {LINE_TOO_LONG_RESPONSE, false}, "", Instrumentation::Clock::now());
+    }
+
+    // Whether the connection's unsent output leaves room to run another of its commands
+    bool outputRoom(Connection& conn) {
+        bool full = conn.output.full(conn.unsent);
+        if (full && !conn.outputPaused) {
+            ctx.stats.readPaused();
+            if (conn.recvArmed) cancelRecv(conn);
+        }
+        conn.outputPaused = full;
+        return !full;
+    }
+
+    // Runs the lines held back while the output was full, once sends have taken enough of it
+    void resume(Connection& conn) {
+        splitLines(conn);
+        if (pooled) dispatch(conn);
+        if (!conn.recvArmed && reading(conn)) armRecv(conn);
+    }
+
+    // The multishot recv ends with -ECANCELED; completions already queued are still framed
+    void cancelRecv(Connection& conn) {
+        int fd = conn.fd;
+        queueSqe([fd](io_uring_sqe* sqe) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = tag(OP_RECV, fd);
+            sqe->user_data = tag(OP_NONE, fd);
+        });
+    }
+
+    void dispatch(Connection& conn) {
+        while (true) {
+            while (!conn.busy && !conn.pending.empty() && outputRoom(conn)) {
+                ReactorCommand command = std::move(conn.pending.front());
+                conn.pending.pop_front();
+                if (command.tooLong) {
+                    respond(conn, {LINE_TOO_LONG_RESPONSE, false}, "", command.start);
+                    continue;
+                }
+                int fd = conn.fd;
+                std::string line = command.line;
+                Instrumentation::Clock::time_point start = command.start;
+                conn.busy = pool->tryEnqueue([this, fd, command](std::function<void()> finished) {
+                    std::vector<std::string> parts = ctx.processor.parse(command.line);
+                    std::string cmd = parts.empty() ? "" : parts[0];
+                    ctx.processor.executeAsync(parts, [this, fd, cmd, start = command.start, finished](const CommandProcessor::Response& response) {
+                        {
+                            std::lock_guard<std::mutex> lock(completionsMutex);
+                            completions.push_back(ReactorCompletion{fd, response, cmd, start});
+                        }
+                        signalWake();
+                        finished();
+                    });
+                });
+                // Nothing of this connection is in flight, so answering now keeps response order
+                if (!conn.busy) {
+                    ctx.stats.busyRejection();
+                    respond(conn, {BUSY_RESPONSE, false}, commandName(line), start);
+                }
+            }
+            if (!conn.readPaused || conn.backlog.full(conn.pending.size())) break;
+            // Below the low watermark: frame what was held back, then read again if that did not
+            // fill the backlog once more
+            conn.readPaused = false;
+            splitLines(conn);
+            if (!conn.recvArmed && reading(conn)) armRecv(conn);
+        }
+    }
+
+    void drainCompletions() {
+        std::vector<ReactorCompletion> done;
+        {
+            std::lock_guard<std::mutex> lock(completionsMutex);
+            done.swap(completions);
+        }
+        for (ReactorCompletion& c : done) {
+            // Connections are kept open while busy, so the lookup cannot miss
+            Connection& conn = *connections.at(c.fd);
+            conn.busy = false;
+            respond(conn, c.response, c.cmd, c.start);
+            dispatch(conn);
+            flush(conn);
+            closeIfDone(conn);
+        }
+    }
+
+    // Latency is recorded when the response is queued; the send is submitted with the next flush
+    void respond(Connection& conn, const CommandProcessor::Response& response, const std::string& cmd,
+                 Instrumentation::Clock::time_point start) {
+        // Once an edge list is queued, later responses line up behind it to keep their order
+        if (response.edges || !conn.streams.empty()) {
+            conn.streams.emplace_back(response);
+            conn.unsent += conn.streams.back().held();
+        } else {
+            conn.queued.push_back(response.text);
+            conn.unsent += response.text.size();
+        }
+        ctx.stats.recordCommand(cmd, start, response.ok);
+        if (ctx.verbose) std::cout << "Client " << conn.fd << " - Sent response: " << response.text;
+    }
+
+    // Submits every queued response as one linked chain, so they hit the socket in order. Edge
+    // lists are copied out a few chunks per chain, so only those chunks are ever held as strings.
+    void flush(Connection& conn) {
+        if (conn.sendsOutstanding > 0 || conn.broken) return;
+        while (conn.queued.empty() && !conn.streams.empty()) {
+            for (size_t i = 0; i < STREAM_CHUNKS && !conn.streams.empty(); ++i) {
+                std::string chunk = conn.streams.front().take(ResponseCursor::CHUNK_BYTES);
+                if (chunk.empty()) {
+                    conn.unsent -= conn.streams.front().held();
+                    conn.streams.pop_front();
+                } else {
+                    conn.unsent += chunk.size();
+                    conn.queued.push_back(std::move(chunk));
+                }
+            }
+        }
+        if (conn.queued.empty()) return;
+        // Requests deferred earlier go first; then the chain takes only what fits in the ring
+        size_t space = deferred.empty() ? ring.sqSpace() : 0;
+        if (space == 0) {
+            if (std::find(flushLater.begin(), flushLater.end(), conn.fd) == flushLater.end()) {
+                flushLater.push_back(conn.fd);
+            }
+            return;
+        }
+        if (conn.queued.size() <= space) {
+            conn.inFlight.swap(conn.queued);
+        } else {
+            for (size_t i = 0; i < space; ++i) {
+                conn.inFlight.push_back(std::move(conn.queued.front()));
+                conn.queued.pop_front();
+            }
+        }
+        for (size_t i = 0; i < conn.inFlight.size(); ++i) {
+            const std::string& chunk = conn.inFlight[i];
+            io_uring_sqe* sqe = ring.getSqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = conn.fd;
+            sqe->addr = reinterpret_cast<uint64_t>(chunk.data());
+            sqe->len = static_cast<uint32_t>(chunk.size());
+            sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+            if (i + 1 < conn.inFlight.size()) sqe->flags = IOSQE_IO_LINK;
+            sqe->user_data = tag(OP_SEND, conn.fd);
+            ++conn.sendsOutstanding;
+        }
+    }
+
+    void onSend(int fd, int res) {
+        auto it = connections.find(fd);
+        if (it == connections.end()) return;
+        Connection& conn = *it->second;
+
+        // Linked requests complete in submission order
+        std::string chunk = std::move(conn.inFlight.front());
+        conn.inFlight.pop_front();
+        --conn.sendsOutstanding;
+        conn.unsent -= chunk.size();
+
+        if (res >= 0) {
+            ctx.stats.bytesSent(res);
+            // A short send cancels the rest of the chain; resubmit the remainder in order
+            if (static_cast<size_t>(res) < chunk.size()) {
+                conn.retry.push_back(chunk.substr(res));
+                conn.unsent += conn.retry.back().size();
+            }
+        } else if (res == -ECANCELED) {
+            conn.unsent += chunk.size();
+            conn.retry.push_back(std::move(chunk));
+        } else {
+            markBroken(conn);
+        }
+
+        if (conn.sendsOutstanding == 0) {
+            while (!conn.retry.empty()) {
+                conn.queued.push_front(std::move(conn.retry.back()));
+                conn.retry.pop_back();
+            }
+            flush(conn);
+            if (conn.outputPaused && !conn.broken) {
+                resume(conn);
+                flush(conn);
+            }
+        }
+        closeIfDone(conn);
+    }
+
+    void markBroken(Connection& conn) {
+        if (conn.broken) return;
+        conn.broken = conn.hungUp = true;
+        conn.in.clear();
+        conn.pending.clear();
+        conn.queued.clear();
+        conn.streams.clear();
+        conn.retry.clear();
+        conn.unsent = 0;
+        for (const std::string& chunk : conn.inFlight) conn.unsent += chunk.size();
+        // Terminates the armed multishot recv so the connection can be released
+        shutdown(conn.fd, SHUT_RDWR);
+    }
+
+    void closeIfDone(Connection& conn) {
+        if (!conn.hungUp || conn.recvArmed || conn.busy || conn.sendsOutstanding > 0) return;
+        if (!conn.pending.empty() || !conn.queued.empty() || !conn.streams.empty()) return;
+        int fd = conn.fd;
+        close(fd);
+        connections.erase(fd);
+        ctx.stats.connectionClosed();
+    }
+
+    bool pooled;
+    std::atomic<bool> stopping;
+    IoUring ring;
+    int wakeFd;
+    uint64_t wakeValue;
+    std::thread loop;
+    std::unique_ptr<WorkerPool> pool;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<ReactorCompletion> completions;
+    std::mutex completionsMutex;
+    std::deque<std::function<void(io_uring_sqe*)>> deferred;  // Requests that found the ring full
+    std::vector<int> flushLater;                              // Connections whose chain did not fit
+};
+
+#endif // URING_REACTOR_HPP
@@ -0,0 +1,422 @@
+#ifndef COMMAND_PROCESSOR_HPP
+#define COMMAND_PROCESSOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "ExternalMST.hpp"
+#include "Graph.hpp"
+#include "GraphFile.hpp"
+#include "MSTFactory.hpp"
+#include "TreePathIndex.hpp"
+#include "MutationLog.hpp"
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+#include "Instrumentation.hpp"
+#include "PerfCounters.hpp"
+
+// Protocol logic shared by every engine: owns the graph, its lock and the optional mutation log.
+// Engines only decide which thread frames, executes and answers each command.
+class CommandProcessor {
+public:
+    // Tree edges listed after the text of a `RunMST <alg> edges` response: a 1-based copy of the
+    // solved tree, so the solver's workspace can take the next solve while the list is sent
+    struct EdgeList {
+        std::vector<MSTEdge> edges;
+        bool binary = false;  // Raw int32 from/to/weight triples in host byte order, not text lines
+    };
+
+    struct Response {
+        std::string text;
+        bool ok;
+        std::shared_ptr<const EdgeList> edges = nullptr;  // Streamed after text by the engine
+    };
+
+    CommandProcessor(Instrumentation& stats, MutationLog* mutationLog = nullptr)
+        : stats(stats), mutationLog(mutationLog), engineName("unknown"),
+          pathTreeVersion(UINT64_MAX), pathIndexVersion(UINT64_MAX) {}
+
+    bool recover() {
+        bool ok = mutationLog == nullptr || mutationLog->recover(graph);
+        publishedVersion = graph.getVersion();
+        return ok;
+    }
+
+    void setEngineName(const std::string& name) { engineName = name; }
+
+    std::vector<std::string> parse(std::string_view command) {
+        return graph.parse(command);
+    }
+
+    // Called with the response of a command, on whichever thread completed it
+    using Completion = std::function<void(const Response&)>;
+
+    // Runs the command on this thread, waiting for the graph lock or for an identical RunMST in
+    // flight as needed. For threads that may block: connection threads and event loops.
+    Response execute(const std::vector<std::string>& command) {
+        std::promise<Response> answer;
+        run(command, true, [&answer](const Response& response) { answer.set_value(response); });
+        return answer.get_future().get();
+    }
+
+    // For scheduler workers, which must not block: the response goes to done, perhaps after this
+    // returns and on another worker. A RunMST identical to one in flight is attached to it, and a
+    // command that finds the graph locked is handed back to the scheduler once the lock is free.
+    void executeAsync(const std::vector<std::string>& command, Completion done) {
+        run(command, false, std::move(done));
+    }
+
+private:
+    void run(const std::vector<std::string>& command, bool mayBlock, const Completion& done) {
+        if (command.empty()) {
+            done({"Command processing failed\n", false});
+            return;
+        }
+        if (command[0] == "RunMST" && command.size() >= 2 && command.size() <= 4) {
+            runMSTOnce(command, mayBlock, done);
+            return;
+        }
+        if (command[0] == "RunMSTFile") {
+            done(runMSTFile(command));
+            return;
+        }
+        auto retry = [&] { return ThreadPool::Task([this, command, done] { run(command, false, done); }); };
+        if (!lockGraph(mayBlock, retry)) return;
+
+        Response response;
+        uint64_t lsn = 0;
+        {
+            // The graph follows --numa even when a pool worker runs the command
+            Topology::GraphMemory placement(MutationLog::isMutation(command[0]));
+            std::lock_guard<GraphMutex> lock(graph_mutex, std::adopt_lock);
+            if (command[0] == "Stats") {
+                response = {stats.report(engineName) + graphStats() + PerfCounters::active().report(), true};
+            } else if (command[0] == "RunMST") {
+                response = {"Command processing failed\n", false};
+            } else if (command[0] == "MSTDist" || command[0] == "MSTMaxEdge") {
+                response = runPathQuery(command);
+            } else if (command[0] == "Batch") {
+                // Every item lands under this one lock hold, so readers never see a partial batch
+                response = runBatch(command);
+                if (response.ok && mutationLog) lsn = mutationLog->append(command, graph);
+            } else {
+                // A malformed number (stoi) or an oversized graph (bad_alloc) fails this command
+                // only, and a failed command is never logged
+                try {
+                    response.ok = graph.eval(command);
+                } catch (const std::exception&) {
+                    response.ok = false;
+                }
+                if (response.ok && mutationLog) lsn = mutationLog->append(command, graph);
+                response.text = response.ok ? "Command processed successfully\n" : "Command processing failed\n";
+            }
+            publishedVersion = graph.getVersion();
+        }
+        // Wait for the group commit outside the graph lock so other mutations can join it. A
+        // command whose record could not be made durable stays applied, so it gets its own status
+        // rather than the one for a command that changed nothing.
+        if (lsn && !mutationLog->waitDurable(lsn)) {
+            response = {"Command applied but not durable\n", false};
+        }
+        done(response);
+    }
+
+    // The graph lock for threads that may wait on it, and for scheduler workers, which must not,
+    // a way to leave a retry behind that the next unlock hands back to the scheduler
+    class GraphMutex {
+    public:
+        void lock() { mutex.lock(); }
+        bool try_lock() { return mutex.try_lock(); }
+
+        void unlock() {
+            mutex.unlock();
+            std::vector<ThreadPool::Task> ready;
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex);
+                ready.swap(deferred);
+            }
+            for (ThreadPool::Task& task : ready) ThreadPool::shared().submit(std::move(task));
+        }
+
+        // Takes the lock, or queues retry for the next unlock and returns false
+        bool lockOr(ThreadPool::Task retry) {
+            if (mutex.try_lock()) return true;
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex);
+                deferred.push_back(std::move(retry));
+            }
+            // The holder may have let go before retry was queued, finding nothing to hand on
+            if (mutex.try_lock()) unlock();
+            return false;
+        }
+
+    private:
+        std::mutex mutex;
+        std::mutex deferredMutex;
+        std::vector<ThreadPool::Task> deferred;
+    };
+
+    // Locks graph_mutex, waiting if the caller may block; otherwise, if it is taken, queues the
+    // task makeRetry() returns and returns false. The task is only made when it is needed, as it
+    // copies the command.
+    template <typename MakeRetry>
+    bool lockGraph(bool mayBlock, MakeRetry&& makeRetry) {
+        if (mayBlock) {
+            graph_mutex.lock();
+            return true;
+        }
+        return graph_mutex.try_lock() || graph_mutex.lockOr(makeRetry());
+    }
+
+    // Caller holds graph_mutex
+    std::string graphStats() {
+        const Graph::IngestStats& ingest = graph.getIngestStats();
+        std::ostringstream oss;
+        oss << "Graph: vertices=" << graph.getNumVertices() << " edges=" << graph.getNumEdges()
+            << " received=" << ingest.received
+            << " parallel_collapsed=" << ingest.parallelCollapsed
+            << " weights_replaced=" << ingest.weightsReplaced
+            << " self_loops_dropped=" << ingest.selfLoopsDropped << "\n";
+        return oss.str();
+    }
+
+    Response runBatch(const std::vector<std::string>& command) {
+        std::vector<size_t> failedItems;
+        if (!graph.evalBatch(command, failedItems)) return {"Command processing failed\n", false};
+        size_t items = (command.size() - 1) / 2;
+        std::ostringstream oss;
+        oss << "Command processed successfully\n";
+        oss << "Batch applied: " << items - failedItems.size() << " of " << items << "\n";
+        if (!failedItems.empty()) {
+            oss << "Failed items:";
+            for (size_t item : failedItems) oss << ' ' << item;
+            oss << "\n";
+        }
+        return {oss.str(), true};
+    }
+
+    using FlightKey = std::tuple<uint64_t, std::string, std::string>;  // Version, algorithm, listing
+
+    // A solve of one algorithm on one graph version, shared by every request that asks for it
+    // while it runs: each one leaves its completion here and the solve answers them all
+    struct Flight {
+        std::vector<Completion> waiters;
+    };
+
+    // Identical requests arriving while a solve is in flight attach to it instead of queueing on
+    // the graph lock to repeat it. The key uses the version last published under the lock; if a
+    // mutation lands before the solve takes the lock, the answer reflects the newer graph, which
+    // is still a state every attached request overlapped with.
+    //
+    // RunMST <alg> [edges [text|binary]]: the tokenizer moves the algorithm behind the options.
+    void runMSTOnce(const std::vector<std::string>& command, bool mayBlock, const Completion& done) {
+        const std::string& algorithm = command.back();
+        std::string listing;
+        if (command.size() > 2) {
+            listing = command.size() == 4 ? command[2] : "text";
+            if (command[1] != "edges" || (listing != "text" && listing != "binary")) {
+                done({"Command processing failed\n", false});
+                return;
+            }
+        }
+
+        FlightKey key(publishedVersion.load(), algorithm, listing);
+        auto flight = std::make_shared<Flight>();
+        {
+            std::lock_guard<std::mutex> lock(flightsMutex);
+            auto it = flights.find(key);
+            if (it != flights.end()) {
+                stats.runCoalesced();
+                it->second->waiters.push_back(done);
+                return;
+            }
+            flight->waiters.push_back(done);
+            flights.emplace(key, flight);
+        }
+        solveFlight(key, flight, mayBlock);
+    }
+
+    // Solves once the graph lock is free, then answers every request attached meanwhile
+    void solveFlight(const FlightKey& key, const std::shared_ptr<Flight>& flight, bool mayBlock) {
+        auto retry = [&] { return ThreadPool::Task([this, key, flight] { solveFlight(key, flight, false); }); };
+        if (!lockGraph(mayBlock, retry)) return;
+        Response response;
+        {
+            std::lock_guard<GraphMutex> graphLock(graph_mutex, std::adopt_lock);
+            response = runMST(std::get<1>(key), std::get<2>(key));
+        }
+        std::vector<Completion> waiters;
+        {
+            std::lock_guard<std::mutex> lock(flightsMutex);
+            waiters.swap(flight->waiters);
+            flights.erase(key);
+        }
+        for (const Completion& waiter : waiters) waiter(response);
+    }
+
+    // listing: "" for the summary only, else the edge list format
+    Response runMST(const std::string& algorithm, const std::string& listing) {
+        try {
+            std::string chosen = algorithm;
+            // The result tree and all scratch arrays are reused from this thread's last solve
+            SolverWorkspace& workspace = SolverWorkspace::forThisThread();
+            MST& mst = workspace.result;
+            PerfCounters::Span solveSpan;
+            if (algorithm == ExternalMST::NAME) {
+                ExternalMST::active().solve(graph, mst);
+            } else {
+                MSTFactory::createAlgorithm(algorithm, graph, chosen)->solve(graph, workspace, mst);
+            }
+            PerfCounters::Reading solveCounts = solveSpan.stop();
+            PerfCounters::Span distanceSpan;
+            mst.calculateDistances(workspace);
+            PerfCounters::Reading distanceCounts = distanceSpan.stop();
+            std::ostringstream oss;
+            oss << "Command processed successfully\n";
+            if (chosen != algorithm) oss << "Algorithm: " << chosen << " (auto)\n";
+            formatSummary(oss, mst);
+            formatPerf(oss, chosen, solveCounts, distanceCounts);
+            std::shared_ptr<EdgeList> list;
+            if (!listing.empty()) {
+                list = std::make_shared<EdgeList>();
+                list->binary = listing == "binary";
+                list->edges.reserve(mst.getEdges().size());
+                for (const MSTEdge& edge : mst.getEdges()) {
+                    list->edges.push_back({edge.from + 1, edge.to + 1, edge.weight});
+                }
+                oss << "Edges: " << list->edges.size() << (list->binary ? " binary" : "") << "\n";
+            }
+            // Later path queries on this graph version answer from this tree
+            pathTree = mst;
+            pathTreeVersion = graph.getVersion();
+            pathIndexVersion = UINT64_MAX;
+            return {oss.str(), true, std::move(list)};
+        } catch (const std::exception& e) {
+            return {"Error running MST algorithm: " + std::string(e.what()) + "\n", false};
+        }
+    }
+
+    // RunMSTFile <name>: the external solver over a graph file too large to load, read in place.
+    // The name is resolved in the data directory like LoadGraph's. The loaded graph is not
+    // involved, so no lock is taken.
+    Response runMSTFile(const std::vector<std::string>& command) {
+        std::string path;
+        if (command.size() != 2 || !DataDirectory::active().resolve(command[1], path)) {
+            return {"Command processing failed\n", false};
+        }
+        try {
+            MST mst;
+            PerfCounters::Span solveSpan;
+            if (!ExternalMST::active().solveFile(path, mst)) return {"Command processing failed\n", false};
+            PerfCounters::Reading solveCounts = solveSpan.stop();
+            PerfCounters::Span distanceSpan;
+            mst.calculateDistances(SolverWorkspace::forThisThread());
+            PerfCounters::Reading distanceCounts = distanceSpan.stop();
+            std::ostringstream oss;
+            oss << "Command processed successfully\n";
+            formatSummary(oss, mst);
+            formatPerf(oss, "RunMSTFile", solveCounts, distanceCounts);
+            return {oss.str(), true};
+        } catch (const std::exception& e) {
+            return {"Error running MST algorithm: " + std::string(e.what()) + "\n", false};
+        }
+    }
+
+    // MSTDist u,v and MSTMaxEdge u,v (1-based; a space also separates them, as both are symmetric).
+    // Answered from the tree of the last RunMST on the current graph version, or from a Kruskal
+    // solve if the graph changed since; the lifting index is rebuilt only when that tree changes.
+    Response runPathQuery(const std::vector<std::string>& command) {
+        if (command.size() != 3) return {"Command processing failed\n", false};
+        int u, v;
+        try {
+            u = std::stoi(command[1]) - 1;
+            v = std::stoi(command[2]) - 1;
+        } catch (const std::exception&) {
+            return {"Command processing failed\n", false};
+        }
+        if (u < 0 || v < 0 || u >= graph.getNumVertices() || v >= graph.getNumVertices()) {
+            return {"Command processing failed\n", false};
+        }
+
+        SolverWorkspace& workspace = SolverWorkspace::forThisThread();
+        if (pathTreeVersion != graph.getVersion()) {
+            MSTFactory::createAlgorithm("Kruskal")->solve(graph, workspace, pathTree);
+            pathTreeVersion = graph.getVersion();
+        }
+        if (pathIndexVersion != pathTreeVersion) {
+            pathIndex.build(pathTree, workspace.arena, ThreadPool::shared());
+            pathIndexVersion = pathTreeVersion;
+        }
+
+        if (!pathIndex.connected(u, v)) return {"Vertices are not connected in the MST\n", false};
+        std::ostringstream oss;
+        oss << "Command processed successfully\n";
+        if (command[0] == "MSTDist") {
+            oss << "MST distance: " << pathIndex.distance(u, v) << "\n";
+        } else {
+            MSTEdge edge;
+            if (!pathIndex.maxEdge(u, v, edge)) return {"MST path has no edges\n", false};
+            oss << "MST max edge: " << edge.from + 1 << "-" << edge.to + 1 << " weight=" << edge.weight << "\n";
+        }
+        return {oss.str(), true};
+    }
+
+    static void formatSummary(std::ostringstream& oss, const MST& mst) {
+        oss << "MST total weight: " << mst.getTotalWeight() << "\n";
+        oss << "Longest distance: " << mst.getLongestDistance() << "\n";
+        oss << "Average distance: " << mst.getAverageDistance() << "\n";
+        oss << "Shortest distance: " << mst.getShortestDistance() << "\n";
+        formatComponents(oss, mst.getComponents());
+    }
+
+    // With --perf-counters, the counts of this solve, also added to the algorithm's totals in Stats
+    static void formatPerf(std::ostringstream& oss, const std::string& algorithm,
+                           const PerfCounters::Reading& solve, const PerfCounters::Reading& distances) {
+        if (!PerfCounters::active().enabled()) return;
+        PerfCounters::active().record(algorithm, solve, distances);
+        PerfCounters::format(oss, "Perf solve:", solve);
+        PerfCounters::format(oss, "Perf distances:", distances);
+    }
+
+    // Forest summary: the component count, then the largest trees when there is more than one
+    static void formatComponents(std::ostringstream& oss, const std::vector<ComponentStats>& components) {
+        static constexpr size_t MAX_LISTED = 10;
+        oss << "Components: " << components.size() << "\n";
+        if (components.size() < 2) return;
+        std::vector<ComponentStats> largest(components);
+        size_t listed = std::min(MAX_LISTED, largest.size());
+        std::partial_sort(largest.begin(), largest.begin() + listed, largest.end(),
+                          [](const ComponentStats& a, const ComponentStats& b) {
+                              return a.vertices != b.vertices ? a.vertices > b.vertices : a.root < b.root;
+                          });
+        for (size_t k = 0; k < listed; ++k) {
+            oss << "Component " << largest[k].root + 1 << ": vertices=" << largest[k].vertices
+                << " weight=" << largest[k].totalWeight << "\n";
+        }
+        if (listed < largest.size()) oss << "(" << largest.size() - listed << " more components)\n";
+    }
+
+    Instrumentation& stats;
+    MutationLog* mutationLog;
+    std::string engineName;
+    Graph graph;
+    GraphMutex graph_mutex;
+    std::atomic<uint64_t> publishedVersion{0};  // graph.getVersion() as of the last command under graph_mutex
+    std::mutex flightsMutex;
+    std::map<FlightKey, std::shared_ptr<Flight>> flights;  // RunMST solves in progress
+    MST pathTree;                // Tree behind MSTDist and MSTMaxEdge
+    uint64_t pathTreeVersion;    // Graph version pathTree was solved on
+    TreePathIndex pathIndex;
+    uint64_t pathIndexVersion;   // pathTreeVersion when pathIndex was built, reset by a new pathTree
+};
+
+#endif // COMMAND_PROCESSOR_HPP
@@ -0,0 +1,137 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "CommandProcessor.hpp"
+#include "Instrumentation.hpp"
+#include "ResponseCursor.hpp"
+#include "Topology.hpp"
+
+// High and low watermarks of a bounded queue. A queue that reaches `high` counts as full until it
+// drains back to `low`, so stalled producers resume in batches instead of on every pop.
+struct QueueLimits {
+    size_t high = 1024;
+    size_t low = 768;
+};
+
+// Full/not-full state of one queue under its limits; callers hold the queue's lock
+class Watermark {
+public:
+    explicit Watermark(const QueueLimits& limits) : limits(limits), saturated(false) {}
+
+    bool full(size_t size) {
+        if (size >= limits.high) saturated = true;
+        else if (size <= limits.low) saturated = false;
+        return saturated;
+    }
+
+private:
+    QueueLimits limits;
+    bool saturated;
+};
+
+// A concurrency engine accepts connections on an already listening socket, frames commands
+// and hands them to the shared CommandProcessor. Engines differ only in threading model.
+class Engine {
+public:
+    struct Context {
+        int listenerSocket;
+        size_t numThreads;
+        CommandProcessor& processor;
+        Instrumentation& stats;
+        bool verbose;           // Log every command and response to stdout
+        QueueLimits queueLimits;  // Bound on every queue between stages
+    };
+
+    // Sent instead of running a command, or to a new connection, when the engine is overloaded
+    static constexpr const char* BUSY_RESPONSE = "Server busy, try again later\n";
+    // Sent before closing a connection whose unterminated line outgrew LineBuffer's maximum
+    static constexpr const char* LINE_TOO_LONG_RESPONSE = "Command line too long\n";
+
+    explicit Engine(const Context& ctx) : ctx(ctx) {}
+    virtual ~Engine() = default;
+
+    virtual void start() = 0;
+    // Stops accepting and joins the engine's threads; the listener is shut down by the caller
+    virtual void stop() = 0;
+    virtual std::string name() const = 0;
+
+protected:
+    // Sends the whole response, retrying on short writes
+    bool sendAll(int fd, const std::string& data) {
+        size_t off = 0;
+        while (off < data.size()) {
+            ssize_t n = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            off += n;
+        }
+        ctx.stats.bytesSent(off);
+        return true;
+    }
+
+    // Blocking send of a whole response, edge list included
+    bool sendAll(int fd, const CommandProcessor::Response& response) {
+        if (!response.edges) return sendAll(fd, response.text);
+        ResponseCursor cursor(response);
+        size_t sent = 0;
+        ssize_t n;
+        while ((n = cursor.sendTo(fd)) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            sent += n;
+        }
+        ctx.stats.bytesSent(sent);
+        return n == 0;
+    }
+
+    // Answers a connection the engine cannot take on and closes it
+    void rejectConnection(int fd) {
+        send(fd, BUSY_RESPONSE, strlen(BUSY_RESPONSE), MSG_NOSIGNAL | MSG_DONTWAIT);
+        close(fd);
+        ctx.stats.busyRejection();
+    }
+
+    // Blocking engines register client sockets so stop() can wake threads parked in recv.
+    // Returns false once shutdownConnections() ran; the caller must then close fd itself.
+    bool trackConnection(int fd) {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        if (connectionsShutdown) return false;
+        connections.insert(fd);
+        return true;
+    }
+
+    void untrackConnection(int fd) {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.erase(fd);
+    }
+
+    void shutdownConnections() {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connectionsShutdown = true;
+        for (int fd : connections) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+    Context ctx;
+
+private:
+    std::mutex connectionsMutex;
+    std::unordered_set<int> connections;
+    bool connectionsShutdown = false;
+};
+
+#endif // ENGINE_HPP
@@ -0,0 +1,42 @@
+#ifndef ENGINE_FACTORY_HPP
+#define ENGINE_FACTORY_HPP
+
+#include "Engine.hpp"
+#include "coroutine_sessions.hpp"
+#include "leader_followers.hpp"
+#include "pipeline_active_object.hpp"
+#include "reactor.hpp"
+#include "uring_reactor.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <stdexcept>
+
+class EngineFactory {
+public:
+    static std::unique_ptr<Engine> createEngine(const std::string& engineName, const Engine::Context& ctx) {
+        if (engineName == "leader-followers") {
+            return std::make_unique<LeaderFollowersThreadPool>(ctx);
+        } else if (engineName == "pipeline") {
+            return std::make_unique<Pipeline>(ctx);
+        } else if (engineName == "reactor") {
+            return std::make_unique<Reactor>(ctx, false);
+        } else if (engineName == "reactor-pool") {
+            return std::make_unique<Reactor>(ctx, true);
+        } else if (engineName == "coroutine") {
+            return std::make_unique<CoroutineSessions>(ctx);
+        } else if (engineName == "uring" || engineName == "uring-pool") {
+            bool pooled = engineName == "uring-pool";
+            auto uring = std::make_unique<UringReactor>(ctx, pooled);
+            if (uring->init()) {
+                return uring;
+            }
+            std::cerr << "io_uring unavailable, falling back to epoll\n";
+            return std::make_unique<Reactor>(ctx, pooled);
+        } else {
+            throw std::invalid_argument("Unknown engine: " + engineName);
+        }
+    }
+};
+
+#endif // ENGINE_FACTORY_HPP
@@ -0,0 +1,129 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "Topology.hpp"
+
+// Counters shared by every engine, so engines are measured the same way.
+// Latency is end to end: from the moment a command line is framed to the moment its
+// response is handed to the socket. Histograms use power-of-two microsecond buckets.
+class Instrumentation {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Instrumentation() : numaStart(Topology::active().counters()) {}
+
+    enum CommandKind {
+        NEW_GRAPH, NEW_EDGE, REMOVE_EDGE, RUN_MST, RUN_MST_FILE, BATCH, LOAD_GRAPH, GENERATE_GRAPH, SAVE_GRAPH, MST_DIST, MST_MAX_EDGE, STATS, OTHER,
+        NUM_KINDS
+    };
+
+    static CommandKind kindOf(const std::string& cmd) {
+        for (int k = 0; k < OTHER; ++k) {
+            if (cmd == KIND_NAMES[k]) return static_cast<CommandKind>(k);
+        }
+        return OTHER;
+    }
+
+    void connectionOpened() { ++connectionsAccepted; ++connectionsOpen; }
+    void connectionClosed() { --connectionsOpen; }
+    void bytesReceived(size_t n) { received += n; }
+    void bytesSent(size_t n) { sent += n; }
+    void busyRejection() { ++busyRejections; }
+    void readPaused() { ++readPauses; }
+    void lineTooLong() { ++overlongLines; }
+    void runCoalesced() { ++coalescedRuns; }
+
+    void recordCommand(const std::string& cmd, Clock::time_point start, bool ok) {
+        uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        CommandStats& s = commands[kindOf(cmd)];
+        ++s.count;
+        if (!ok) ++s.failures;
+        s.totalUs += us;
+        uint64_t prev = s.maxUs.load(std::memory_order_relaxed);
+        while (us > prev && !s.maxUs.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+        ++s.buckets[bucketOf(us)];
+    }
+
+    std::string report(const std::string& engineName) const {
+        std::ostringstream oss;
+        oss << "Engine: " << engineName << "\n"
+            << "Connections: " << connectionsAccepted.load() << " accepted, " << connectionsOpen.load() << " open\n"
+            << "Bytes: " << received.load() << " received, " << sent.load() << " sent\n"
+            << "Backpressure: " << readPauses.load() << " read pauses, " << busyRejections.load() << " busy rejections, "
+            << overlongLines.load() << " connections closed on overlong lines\n"
+            << "Coalesced: " << coalescedRuns.load() << " RunMST answered by a solve already in flight\n";
+        // Page allocations on the whole machine since startup
+        Topology::NumaCounters numa = Topology::active().counters();
+        oss << "NUMA: " << Topology::active().numNodes() << " nodes, "
+            << numa.localNode - numaStart.localNode << " local pages, "
+            << numa.otherNode - numaStart.otherNode << " remote pages, "
+            << numa.interleave - numaStart.interleave << " interleaved, "
+            << numa.miss - numaStart.miss << " misses\n";
+        for (int k = 0; k < NUM_KINDS; ++k) {
+            const CommandStats& s = commands[k];
+            uint64_t count = s.count.load();
+            if (count == 0) continue;
+            oss << KIND_NAMES[k] << ": count=" << count
+                << " failed=" << s.failures.load()
+                << " avg_us=" << s.totalUs.load() / count
+                << " p50_us<=" << s.percentileUs(0.50)
+                << " p99_us<=" << s.percentileUs(0.99)
+                << " max_us=" << s.maxUs.load() << "\n";
+        }
+        return oss.str();
+    }
+
+private:
+    static constexpr int NUM_BUCKETS = 40;
+    static constexpr const char* KIND_NAMES[NUM_KINDS] = {
+        "NewGraph", "NewEdge", "RemoveEdge", "RunMST", "RunMSTFile", "Batch", "LoadGraph", "GenerateGraph", "SaveGraph", "MSTDist", "MSTMaxEdge",
+        "Stats", "Other"
+    };
+
+    static int bucketOf(uint64_t us) {
+        int b = 0;
+        while (us > 0 && b < NUM_BUCKETS - 1) {
+            us >>= 1;
+            ++b;
+        }
+        return b;
+    }
+
+    struct CommandStats {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> totalUs{0};
+        std::atomic<uint64_t> maxUs{0};
+        std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+
+        // Upper bound of the bucket holding the given quantile
+        uint64_t percentileUs(double q) const {
+            uint64_t total = count.load(), seen = 0;
+            for (int b = 0; b < NUM_BUCKETS; ++b) {
+                seen += buckets[b].load();
+                if (seen > 0 && seen >= q * total) return b == 0 ? 0 : (uint64_t(1) << b) - 1;
+            }
+            return maxUs.load();
+        }
+    };
+
+    std::atomic<uint64_t> connectionsAccepted{0};
+    std::atomic<int64_t> connectionsOpen{0};
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> readPauses{0};      // Times a reader stopped reading because its queue or unsent output was full
+    std::atomic<uint64_t> busyRejections{0};  // Commands or connections answered with the busy response
+    std::atomic<uint64_t> overlongLines{0};   // Connections closed for a line past LineBuffer's maximum
+    std::atomic<uint64_t> coalescedRuns{0};
+    std::array<CommandStats, NUM_KINDS> commands;
+    Topology::NumaCounters numaStart;
+};
+
+#endif // INSTRUMENTATION_HPP
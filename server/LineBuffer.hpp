@@ -0,0 +1,102 @@
+#ifndef LINE_BUFFER_HPP
+#define LINE_BUFFER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+// Receive buffer of one connection. Unframed bytes sit in [readPos, writePos) of a single array:
+// recv writes straight into the free tail, and nextLine() hands out each complete command as a
+// view into the array. The search for '\n' resumes where the previous one stopped, and unread
+// bytes are moved to the front only when the tail runs out of room, so a pipelined burst is
+// framed in time linear in its size, without a copy or an erase per command.
+//
+// A line is allowed to grow to the configured maximum before its '\n' arrives; engines check
+// overlong() after framing and answer with Engine::LINE_TOO_LONG_RESPONSE, then close, so a
+// client cannot make the server buffer without bound.
+class LineBuffer {
+public:
+    static constexpr size_t RECV_SIZE = 64 * 1024;  // Room offered to each recv
+    static constexpr size_t MIN_CAPACITY = 4096;
+    static constexpr size_t DEFAULT_MAX_LINE = size_t(64) << 20;
+
+    // Longest command line every connection accepts from now on
+    static void configureMaxLine(size_t bytes) { maxLine() = bytes; }
+
+    // At least `want` bytes of free space after the unread data; invalidates earlier views
+    char* space(size_t want = RECV_SIZE) {
+        if (readPos == writePos) readPos = scanPos = writePos = 0;
+        if (capacity - writePos >= want) return data.get() + writePos;
+        size_t unread = writePos - readPos;
+        if (unread + want <= capacity) {
+            std::memmove(data.get(), data.get() + readPos, unread);
+        } else {
+            size_t grown = std::max({capacity * 2, unread + want, MIN_CAPACITY});
+            std::unique_ptr<char[]> larger(new char[grown]);
+            if (unread > 0) std::memcpy(larger.get(), data.get() + readPos, unread);
+            data = std::move(larger);
+            capacity = grown;
+        }
+        scanPos -= readPos;
+        readPos = 0;
+        writePos = unread;
+        return data.get() + writePos;
+    }
+
+    size_t spaceSize() const { return capacity - writePos; }
+    void commit(size_t n) { writePos += n; }
+
+    void append(const char* bytes, size_t n) {
+        std::memcpy(space(n), bytes, n);
+        commit(n);
+    }
+
+    // Next complete line without its '\n'; the view is valid until the next space() or append()
+    bool nextLine(std::string_view& line) {
+        if (scanPos == writePos) return false;
+        const char* scan = data.get() + scanPos;
+        const char* newline = static_cast<const char*>(std::memchr(scan, '\n', writePos - scanPos));
+        if (!newline) {
+            scanPos = writePos;
+            return false;
+        }
+        size_t end = newline - data.get();
+        line = std::string_view(data.get() + readPos, end - readPos);
+        readPos = scanPos = end + 1;
+        return true;
+    }
+
+    bool empty() const { return readPos == writePos; }
+
+    // The unframed bytes, all scanned without finding a '\n', are past the maximum line length
+    bool overlong() const { return scanPos == writePos && writePos - readPos > maxLine(); }
+
+    // Drops the unframed bytes and the memory holding them
+    void clear() {
+        data.reset();
+        capacity = readPos = scanPos = writePos = 0;
+    }
+
+    // Returns memory a burst grew the buffer to once it has been drained, so idle connections of
+    // the event-loop engines hold no more than MIN_CAPACITY
+    void trim() {
+        if (!empty() || capacity <= MIN_CAPACITY) return;
+        clear();
+    }
+
+private:
+    static size_t& maxLine() {
+        static size_t bytes = DEFAULT_MAX_LINE;
+        return bytes;
+    }
+
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+    size_t readPos = 0;   // First byte not yet handed out as a line
+    size_t scanPos = 0;   // Bytes before this are known to hold no '\n' past readPos
+    size_t writePos = 0;  // End of the received bytes
+};
+
+#endif // LINE_BUFFER_HPP
@@ -0,0 +1,254 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Hardware counters around RunMST, for --perf-counters. Each measured span reads perf_event_open
+// counters of the calling thread, user space only, so the default perf_event_paranoid of 2 is
+// enough: cycles, instructions, LLC misses and branch misses as one group, scheduled together so
+// their ratios hold, and page faults on their own, as software events work without a PMU. An
+// event the kernel refuses (no PMU in a VM, paranoid 3) reads as n/a. Counts are scaled by the
+// share of the span the group was scheduled, and only cover the solving thread, not solver pool
+// workers helping a parallel algorithm.
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, PAGE_FAULTS, NUM_EVENTS };
+
+    struct Reading {
+        std::array<uint64_t, NUM_EVENTS> counts{};
+        std::array<bool, NUM_EVENTS> available{};
+    };
+
+    // Counts from construction to stop(); does nothing while profiling is off
+    class Span;
+
+    // Opens the counters on the calling thread to check any can be read. False if none can, in
+    // which case profiling stays off.
+    bool configure() {
+        on = CounterGroups::forThisThread().any();
+        return on;
+    }
+
+    bool enabled() const { return on; }
+
+    // Adds one solve to the totals of its algorithm
+    void record(const std::string& algorithm, const Reading& solve, const Reading& distances) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Totals& totals = byAlgorithm[algorithm];
+        totals.solve.add(solve);
+        totals.distances.add(distances);
+    }
+
+    // Per algorithm and phase, the average counts per measured run
+    std::string report() const {
+        std::ostringstream oss;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [algorithm, totals] : byAlgorithm) {
+            totals.solve.format(oss, "Perf " + algorithm + " solve");
+            totals.distances.format(oss, "Perf " + algorithm + " distances");
+        }
+        return oss.str();
+    }
+
+    // One line: the label, then cycles=... instructions=... ipc=... llc_misses=... branch_misses=...
+    // page_faults=...
+    static void format(std::ostream& out, const std::string& label, const Reading& reading) {
+        out << label;
+        for (int e = 0; e < NUM_EVENTS; ++e) {
+            out << ' ' << EVENT_NAMES[e] << '=';
+            if (reading.available[e]) out << reading.counts[e];
+            else out << "n/a";
+            if (e == INSTRUCTIONS) {
+                out << " ipc=";
+                if (reading.available[CYCLES] && reading.available[INSTRUCTIONS] && reading.counts[CYCLES] > 0) {
+                    out << std::fixed << std::setprecision(2)
+                        << static_cast<double>(reading.counts[INSTRUCTIONS]) / reading.counts[CYCLES];
+                    out.unsetf(std::ios_base::floatfield);
+                } else {
+                    out << "n/a";
+                }
+            }
+        }
+        out << "\n";
+    }
+
+    // Set once at startup by --perf-counters
+    static PerfCounters& active() {
+        static PerfCounters instance;
+        return instance;
+    }
+
+private:
+    static constexpr int NUM_GROUPS = 2;
+    static constexpr int GROUP_OF[NUM_EVENTS] = {0, 0, 0, 0, 1};  // Hardware group, then software
+    static constexpr const char* EVENT_NAMES[NUM_EVENTS] = {
+        "cycles", "instructions", "llc_misses", "branch_misses", "page_faults"
+    };
+    static constexpr uint32_t EVENT_TYPES[NUM_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE
+    };
+    static constexpr uint64_t EVENT_CONFIGS[NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS
+    };
+
+    struct Snapshot {
+        struct Group {
+            uint64_t enabled = 0;  // Nanoseconds enabled, and of those scheduled on the PMU
+            uint64_t running = 0;
+        };
+        std::array<Group, NUM_GROUPS> groups{};
+        std::array<uint64_t, NUM_EVENTS> counts{};
+        std::array<bool, NUM_EVENTS> valid{};
+    };
+
+    // The calling thread's counters, opened on its first measured span and kept for its lifetime
+    class CounterGroups {
+    public:
+        CounterGroups() {
+            leaders.fill(-1);
+            fds.fill(-1);
+            slots.fill(-1);
+            std::array<int, NUM_GROUPS> members{};
+            for (int e = 0; e < NUM_EVENTS; ++e) {
+                int g = GROUP_OF[e];
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof attr);
+                attr.size = sizeof attr;
+                attr.type = EVENT_TYPES[e];
+                attr.config = EVENT_CONFIGS[e];
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                // A member the PMU lacks is skipped; the first one that opens leads its group
+                int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leaders[g], PERF_FLAG_FD_CLOEXEC));
+                if (fd == -1) continue;
+                fds[e] = fd;
+                if (leaders[g] == -1) leaders[g] = fd;
+                slots[e] = members[g]++;
+            }
+        }
+
+        ~CounterGroups() {
+            for (int fd : fds) {
+                if (fd != -1) close(fd);
+            }
+        }
+
+        CounterGroups(const CounterGroups&) = delete;
+        CounterGroups& operator=(const CounterGroups&) = delete;
+
+        bool any() const {
+            for (int leader : leaders) {
+                if (leader != -1) return true;
+            }
+            return false;
+        }
+
+        Snapshot read() const {
+            Snapshot snapshot;
+            for (int g = 0; g < NUM_GROUPS; ++g) {
+                if (leaders[g] == -1) continue;
+                // nr, time enabled, time running, then one value per member
+                uint64_t values[3 + NUM_EVENTS];
+                ssize_t n = ::read(leaders[g], values, sizeof values);
+                if (n < static_cast<ssize_t>(3 * sizeof(uint64_t))) continue;
+                snapshot.groups[g] = {values[1], values[2]};
+                for (int e = 0; e < NUM_EVENTS; ++e) {
+                    if (GROUP_OF[e] != g || slots[e] == -1 || static_cast<uint64_t>(slots[e]) >= values[0]) continue;
+                    snapshot.counts[e] = values[3 + slots[e]];
+                    snapshot.valid[e] = true;
+                }
+            }
+            return snapshot;
+        }
+
+        static CounterGroups& forThisThread() {
+            thread_local CounterGroups groups;
+            return groups;
+        }
+
+    private:
+        std::array<int, NUM_GROUPS> leaders;
+        std::array<int, NUM_EVENTS> fds;
+        std::array<int, NUM_EVENTS> slots;  // Position of each event in its group's read, -1 if not open
+    };
+
+    // Sums over the runs that could read each event
+    struct Phase {
+        std::array<uint64_t, NUM_EVENTS> sums{};
+        std::array<uint64_t, NUM_EVENTS> runs{};
+
+        void add(const Reading& reading) {
+            for (int e = 0; e < NUM_EVENTS; ++e) {
+                if (!reading.available[e]) continue;
+                sums[e] += reading.counts[e];
+                ++runs[e];
+            }
+        }
+
+        void format(std::ostream& out, const std::string& label) const {
+            Reading average;
+            uint64_t measured = 0;
+            for (int e = 0; e < NUM_EVENTS; ++e) {
+                if (runs[e] == 0) continue;
+                average.counts[e] = sums[e] / runs[e];
+                average.available[e] = true;
+                measured = std::max(measured, runs[e]);
+            }
+            PerfCounters::format(out, label + ": runs=" + std::to_string(measured), average);
+        }
+    };
+
+    struct Totals {
+        Phase solve;
+        Phase distances;
+    };
+
+    bool on = false;
+    mutable std::mutex mutex;
+    std::map<std::string, Totals> byAlgorithm;
+};
+
+// Counts from construction to stop(); does nothing while profiling is off
+class PerfCounters::Span {
+public:
+    Span() : group(active().enabled() ? &CounterGroups::forThisThread() : nullptr) {
+        if (group) start = group->read();
+    }
+
+    Reading stop() const {
+        Reading reading;
+        if (!group) return reading;
+        Snapshot end = group->read();
+        for (int e = 0; e < NUM_EVENTS; ++e) {
+            const Snapshot::Group& before = start.groups[GROUP_OF[e]];
+            const Snapshot::Group& after = end.groups[GROUP_OF[e]];
+            uint64_t enabled = after.enabled - before.enabled;
+            uint64_t running = after.running - before.running;
+            if (!start.valid[e] || !end.valid[e] || running == 0) continue;
+            double delta = static_cast<double>(end.counts[e] - start.counts[e]);
+            reading.counts[e] = static_cast<uint64_t>(delta * enabled / running);
+            reading.available[e] = true;
+        }
+        return reading;
+    }
+
+private:
+    const CounterGroups* group;
+    Snapshot start;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,119 @@
+#ifndef RESPONSE_CURSOR_HPP
+#define RESPONSE_CURSOR_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "CommandProcessor.hpp"
+
+// Send position within one response: its text, then its edge list if it has one. The list is
+// never rendered whole. Text lines are formatted a chunk at a time into a buffer the cursor
+// reuses, and binary records are sent straight out of the edge array, so a tree of millions of
+// edges goes out through one scatter-gather send per chunk.
+class ResponseCursor {
+    static_assert(sizeof(MSTEdge) == 3 * sizeof(int32_t), "binary edge lists are int32 triples");
+
+public:
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+
+    explicit ResponseCursor(const CommandProcessor::Response& response)
+        : text(response.text), list(response.edges) {}
+
+    // Points iov at the next unsent bytes: the rest of the text and the current chunk of the list.
+    // Returns how many of the two entries it filled, 0 once everything is sent.
+    int next(iovec iov[2]) {
+        int count = 0;
+        if (textSent < text.size()) iov[count++] = {text.data() + textSent, text.size() - textSent};
+        if (!list) return count;
+        if (list->binary) {
+            size_t total = list->edges.size() * sizeof(MSTEdge);
+            if (binarySent < total) {
+                const char* bytes = reinterpret_cast<const char*>(list->edges.data());
+                iov[count++] = {const_cast<char*>(bytes) + binarySent, std::min(CHUNK_BYTES, total - binarySent)};
+            }
+            return count;
+        }
+        if (chunkSent == chunk.size()) formatChunk();
+        if (chunkSent < chunk.size()) iov[count++] = {chunk.data() + chunkSent, chunk.size() - chunkSent};
+        return count;
+    }
+
+    // Marks n bytes of what next() returned as sent
+    void advance(size_t n) {
+        size_t fromText = std::min(n, text.size() - textSent);
+        textSent += fromText;
+        n -= fromText;
+        if (!list) return;
+        if (list->binary) binarySent += n;
+        else chunkSent += n;
+    }
+
+    // Memory the response keeps alive until the cursor is dropped: its text and edge array
+    size_t held() const { return text.size() + (list ? list->edges.size() * sizeof(MSTEdge) : 0); }
+
+    bool done() {
+        iovec iov[2];
+        return next(iov) == 0;
+    }
+
+    // One non-blocking-friendly send of the next bytes; returns what sendmsg returned, or 0 when
+    // nothing is left
+    ssize_t sendTo(int fd) {
+        iovec iov[2];
+        int count = next(iov);
+        if (count == 0) return 0;
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n > 0) advance(n);
+        return n;
+    }
+
+    // Copies up to max of the next bytes out, for engines whose sends need buffers they own
+    std::string take(size_t max) {
+        std::string out;
+        iovec iov[2];
+        int count = next(iov);
+        for (int i = 0; i < count && out.size() < max; ++i) {
+            out.append(static_cast<const char*>(iov[i].iov_base), std::min(iov[i].iov_len, max - out.size()));
+        }
+        advance(out.size());
+        return out;
+    }
+
+private:
+    void formatChunk() {
+        static constexpr size_t MAX_LINE = 3 * 12;  // Three ints, their separators and the newline
+        chunk.clear();
+        chunk.reserve(CHUNK_BYTES);
+        chunkSent = 0;
+        while (chunk.size() + MAX_LINE <= CHUNK_BYTES && nextEdge < list->edges.size()) {
+            const MSTEdge& edge = list->edges[nextEdge++];
+            appendInt(edge.from, ' ');
+            appendInt(edge.to, ' ');
+            appendInt(edge.weight, '\n');
+        }
+    }
+
+    void appendInt(int value, char separator) {
+        char digits[12];
+        chunk.append(digits, std::to_chars(digits, digits + sizeof digits, value).ptr);
+        chunk.push_back(separator);
+    }
+
+    std::string text;
+    size_t textSent = 0;
+    std::shared_ptr<const CommandProcessor::EdgeList> list;
+    size_t binarySent = 0;  // Bytes of the edge array sent, binary lists
+    size_t nextEdge = 0;    // First edge not yet formatted, text lists
+    std::string chunk;      // Formatted lines of the current text chunk
+    size_t chunkSent = 0;
+};
+
+#endif // RESPONSE_CURSOR_HPP
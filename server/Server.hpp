@@ -0,0 +1,228 @@
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BoruvkaKernels.hpp"
+#include "CommandProcessor.hpp"
+#include "CostModel.hpp"
+#include "EngineFactory.hpp"
+#include "ExternalMST.hpp"
+#include "GraphFile.hpp"
+#include "Instrumentation.hpp"
+#include "LineBuffer.hpp"
+#include "MutationLog.hpp"
+#include "PerfCounters.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+
+struct ServerConfig {
+    std::string engine = "leader-followers";
+    size_t numThreads = std::max(2u, std::thread::hardware_concurrency());  // Over all shards
+    QueueLimits queueLimits;  // Watermarks for every engine queue, over all shards
+    size_t solverThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::string simd = "auto";  // Boruvka kernel: auto, avx512, avx2 or scalar
+    std::string costModel;  // Coefficients for RunMST Auto written by mst_bench; empty keeps defaults
+    std::string dataDir = ".";  // LoadGraph, SaveGraph and RunMSTFile names are relative to it
+    std::string scratchDir = "/tmp";                      // Sorted runs of RunMST External and RunMSTFile
+    size_t externalBudget = ExternalMST::DEFAULT_BUDGET;  // Bytes of edges those hold in memory
+    size_t arenaRetained = Arena::DEFAULT_RETAINED;       // Solver scratch bytes kept per thread
+    size_t maxLine = LineBuffer::DEFAULT_MAX_LINE;        // Longest command line a connection may send
+    std::string pin = "none";     // "cores" pins engine and solver threads to CPUs
+    std::string numa = "default";  // Graph memory: default (first touch), interleave, or a node number
+    std::string port = "9034";
+    int backlog = SOMAXCONN;  // Pending connections the kernel queues per listener
+    size_t shards = 1;        // SO_REUSEPORT listeners, each with its own engine; 0 means one per core
+    bool verbose = true;
+    bool perfCounters = false;  // Hardware counters around every RunMST solve
+
+    std::string walDir;  // Empty disables the mutation log
+    std::chrono::microseconds commitWindow{200};
+    uint64_t checkpointInterval = 100000;
+};
+
+class Server {
+public:
+    Server(const ServerConfig& config) : config(config) {
+        if (this->config.shards == 0) this->config.shards = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ~Server() {
+        stop();
+    }
+
+    bool start() {
+        ThreadPool::configure(config.solverThreads);
+        Arena::configureRetained(config.arenaRetained);
+        LineBuffer::configureMaxLine(config.maxLine);
+        if (!Topology::active().setPinning(config.pin)) {
+            std::cerr << "Unknown pinning mode " << config.pin << "\n";
+            return false;
+        }
+        if (!Topology::active().setMemoryPolicy(config.numa)) {
+            std::cerr << "Unknown NUMA policy " << config.numa << "\n";
+            return false;
+        }
+        // Engine threads inherit the policy, so the graph they build follows it
+        if (!Topology::active().applyMemoryPolicy()) {
+            return false;
+        }
+        if (!BoruvkaKernels::force(config.simd)) {
+            std::cerr << "SIMD level " << config.simd << " is not supported on this CPU\n";
+            return false;
+        }
+        if (!config.costModel.empty() && !CostModel::active().load(config.costModel)) {
+            return false;
+        }
+        if (!DataDirectory::active().configure(config.dataDir)) {
+            std::cerr << "Data directory " << config.dataDir << " does not exist\n";
+            return false;
+        }
+        if (!ExternalMST::active().configure(config.scratchDir, config.externalBudget)) {
+            std::cerr << "Scratch directory " << config.scratchDir << " must be writable and the external MST budget at least "
+                      << (ExternalMST::MIN_BUDGET >> 20) << " MB\n";
+            return false;
+        }
+        // Counters are a diagnostic, so a kernel that refuses them only turns profiling off
+        if (config.perfCounters && !PerfCounters::active().configure()) {
+            std::cerr << "No performance counters can be opened (see /proc/sys/kernel/perf_event_paranoid); "
+                      << "--perf-counters ignored\n";
+        }
+        if (!config.walDir.empty()) {
+            mutationLog = std::make_unique<MutationLog>(config.walDir, config.commitWindow, config.checkpointInterval);
+        }
+        processor = std::make_unique<CommandProcessor>(stats, mutationLog.get());
+        if (!processor->recover()) {
+            std::cerr << "Failed to recover graph from mutation log\n";
+            return false;
+        }
+
+        // Every shard binds the same port with SO_REUSEPORT, so the kernel spreads incoming
+        // connections over their accept queues and no single acceptor serializes them
+        for (size_t i = 0; i < config.shards; ++i) {
+            int listener = setup_listener(config.shards > 1);
+            if (listener == -1) {
+                std::cerr << "Failed to setup listener\n";
+                closeListeners();
+                return false;
+            }
+            listeners.push_back(listener);
+        }
+
+        // Threads and queue bounds are for the whole server, so each shard gets its share; a
+        // connection lives in one shard, so its own queue cannot usefully exceed the shard's
+        size_t shardThreads = std::max<size_t>(1, (config.numThreads + config.shards - 1) / config.shards);
+        QueueLimits shardLimits;
+        shardLimits.high = std::max<size_t>(1, (config.queueLimits.high + config.shards - 1) / config.shards);
+        shardLimits.low = std::min(shardLimits.high - 1, config.queueLimits.low * shardLimits.high / config.queueLimits.high);
+        try {
+            for (int listener : listeners) {
+                engines.push_back(EngineFactory::createEngine(config.engine,
+                    Engine::Context{listener, shardThreads, *processor, stats, config.verbose, shardLimits}));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            engines.clear();
+            closeListeners();
+            return false;
+        }
+        processor->setEngineName(engines.front()->name());
+        for (auto& engine : engines) engine->start();
+
+        std::cout << "Server running on port " << config.port << " with " << engines.front()->name()
+                  << " engine (" << shardThreads << " threads";
+        if (config.shards > 1) std::cout << " in each of " << config.shards << " shards";
+        std::cout << ")" << std::endl;
+        return true;
+    }
+
+    void stop() {
+        // Wakes threads blocked in accept before the engines join them
+        for (int listener : listeners) shutdown(listener, SHUT_RDWR);
+        if (!engines.empty()) {
+            for (auto& engine : engines) engine->stop();
+            std::cout << stats.report(engines.front()->name());
+            engines.clear();
+        }
+        closeListeners();
+    }
+
+private:
+    ServerConfig config;
+    Instrumentation stats;
+    std::unique_ptr<MutationLog> mutationLog;
+    std::unique_ptr<CommandProcessor> processor;
+    std::vector<std::unique_ptr<Engine>> engines;  // One per shard, each on its own listener
+    std::vector<int> listeners;
+
+    void closeListeners() {
+        for (int listener : listeners) close(listener);
+        listeners.clear();
+    }
+
+    int setup_listener(bool reusePort) {
+        struct addrinfo hints{}, *ai, *p;
+        int listener;
+        int yes = 1;
+        int rv;
+
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        if ((rv = getaddrinfo(nullptr, config.port.c_str(), &hints, &ai)) != 0) {
+            std::cerr << "getaddrinfo: " << gai_strerror(rv) << '\n';
+            return -1;
+        }
+
+        for(p = ai; p != nullptr; p = p->ai_next) {
+            listener = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+            if (listener < 0) continue;
+
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int));
+            if (reusePort && setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int)) == -1) {
+                perror("setsockopt SO_REUSEPORT");
+                close(listener);
+                continue;
+            }
+
+            if (bind(listener, p->ai_addr, p->ai_addrlen) < 0) {
+                close(listener);
+                continue;
+            }
+
+            break;
+        }
+
+        freeaddrinfo(ai);
+
+        if (p == nullptr) {
+            std::cerr << "Failed to bind\n";
+            return -1;
+        }
+
+        if (listen(listener, config.backlog) == -1) {
+            perror("listen");
+            close(listener);
+            return -1;
+        }
+
+        return listener;
+    }
+};
+
+#endif // SERVER_HPP
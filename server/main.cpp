@@ -0,0 +1,146 @@
+#include "Server.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <thread>
+
+std::atomic<bool> running(true);
+
+void signal_handler(int) {
+    running = false;
+}
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "  --engine NAME           leader-followers (default), pipeline, reactor, reactor-pool,\n"
+              << "                          uring, uring-pool (epoll fallback), coroutine\n"
+              << "  --threads N             worker threads for leader-followers, split across shards\n"
+              << "  --queue-high N          queue length at which readers pause and the busy response\n"
+              << "                          starts (default 1024), split across shards\n"
+              << "  --queue-low N           queue length at which they resume (default 3/4 of high)\n"
+              << "  --solver-threads N      work-stealing scheduler threads shared by parallel solves and\n"
+              << "                          *-pool and coroutine engine commands, including a loop's caller\n"
+              << "  --simd LEVEL            Boruvka kernel: auto (default), avx512, avx2, scalar\n"
+              << "  --cost-model FILE       RunMST Auto coefficients written by mst_bench\n"
+              << "  --data-dir DIR          directory LoadGraph, SaveGraph and RunMSTFile names are\n"
+              << "                          relative to; absolute names and .. are refused (default .)\n"
+              << "  --scratch-dir DIR       where RunMST External and RunMSTFile spill sorted edge runs\n"
+              << "                          (default /tmp)\n"
+              << "  --em-budget-mb N        memory for their edges before spilling (default 256)\n"
+              << "  --arena-retain-mb N     solver scratch memory each thread keeps between solves;\n"
+              << "                          larger solves allocate theirs every time (default 256)\n"
+              << "  --max-line-mb N         longest command line accepted; a connection sending a\n"
+              << "                          longer one gets an error and is closed (default 64)\n"
+              << "  --pin MODE              none (default) or cores: pin engine and solver threads\n"
+              << "  --numa POLICY           graph memory: default (first touch), interleave, or a\n"
+              << "                          node number to prefer\n"
+              << "  --port PORT             listening port (default 9034)\n"
+              << "  --backlog N             listen backlog per listener (default SOMAXCONN)\n"
+              << "  --shards N              SO_REUSEPORT listeners, each with its own engine;\n"
+              << "                          0 opens one per core (default 1)\n"
+              << "  --quiet                 do not log every command\n"
+              << "  --perf-counters         report cycles, instructions, LLC and branch misses and page\n"
+              << "                          faults of every RunMST solve, and their averages in Stats\n"
+              << "  --wal DIR               persist mutations to a write-ahead log in DIR\n"
+              << "  --commit-window-us N    group commit window (default 200)\n"
+              << "  --checkpoint-every N    snapshot after N logged mutations (default 100000)\n";
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    bool queueLowSet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quiet") {
+            config.verbose = false;
+            continue;
+        }
+        if (arg == "--perf-counters") {
+            config.perfCounters = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        // std::sto* throw on a malformed or out-of-range number
+        try {
+            if (arg == "--engine") {
+                config.engine = argv[++i];
+            } else if (arg == "--threads") {
+                config.numThreads = std::stoul(argv[++i]);
+            } else if (arg == "--queue-high") {
+                config.queueLimits.high = std::stoul(argv[++i]);
+            } else if (arg == "--queue-low") {
+                config.queueLimits.low = std::stoul(argv[++i]);
+                queueLowSet = true;
+            } else if (arg == "--solver-threads") {
+                config.solverThreads = std::stoul(argv[++i]);
+            } else if (arg == "--simd") {
+                config.simd = argv[++i];
+            } else if (arg == "--cost-model") {
+                config.costModel = argv[++i];
+            } else if (arg == "--data-dir") {
+                config.dataDir = argv[++i];
+            } else if (arg == "--scratch-dir") {
+                config.scratchDir = argv[++i];
+            } else if (arg == "--em-budget-mb") {
+                config.externalBudget = std::stoul(argv[++i]) << 20;
+            } else if (arg == "--arena-retain-mb") {
+                config.arenaRetained = std::stoul(argv[++i]) << 20;
+            } else if (arg == "--max-line-mb") {
+                config.maxLine = std::stoul(argv[++i]) << 20;
+            } else if (arg == "--pin") {
+                config.pin = argv[++i];
+            } else if (arg == "--numa") {
+                config.numa = argv[++i];
+            } else if (arg == "--port") {
+                config.port = argv[++i];
+            } else if (arg == "--backlog") {
+                config.backlog = std::stoi(argv[++i]);
+            } else if (arg == "--shards") {
+                config.shards = std::stoul(argv[++i]);
+            } else if (arg == "--wal") {
+                config.walDir = argv[++i];
+            } else if (arg == "--commit-window-us") {
+                config.commitWindow = std::chrono::microseconds(std::stol(argv[++i]));
+            } else if (arg == "--checkpoint-every") {
+                config.checkpointInterval = std::stoull(argv[++i]);
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::logic_error&) {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << '\n';
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!queueLowSet) config.queueLimits.low = config.queueLimits.high * 3 / 4;
+    if (config.queueLimits.high == 0 || config.queueLimits.low >= config.queueLimits.high) {
+        std::cerr << "--queue-low must be below --queue-high\n";
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    Server server(config);
+    if (!server.start()) {
+        return 1;
+    }
+
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::cout << "Shutting down server..." << std::endl;
+    server.stop();
+    std::cout << "Server shut down completely." << std::endl;
+    return 0;
+}
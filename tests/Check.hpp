@@ -0,0 +1,30 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// Minimal assertions for the test programs run by `make test`. A failed CHECK reports its
+// location and the test keeps going, so one run lists every failure; main returns checkResult().
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed\n";  \
+            ++checkFailures();                                                                \
+        }                                                                                     \
+    } while (0)
+
+inline int checkResult(const char* name) {
+    if (checkFailures() == 0) {
+        std::cout << name << ": ok" << std::endl;
+        return 0;
+    }
+    std::cerr << name << ": " << checkFailures() << " checks failed" << std::endl;
+    return 1;
+}
+
+#endif // CHECK_HPP
@@ -0,0 +1,75 @@
+#ifndef TEST_SERVER_HPP
+#define TEST_SERVER_HPP
+
+#include <memory>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Check.hpp"
+#include "EngineFactory.hpp"
+#include "Instrumentation.hpp"
+
+// One engine serving a fresh processor on an ephemeral loopback port
+class TestServer {
+public:
+    explicit TestServer(const std::string& engineName) : processor(stats) {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof addr;
+        CHECK(bind(listener, reinterpret_cast<sockaddr*>(&addr), len) == 0);
+        CHECK(listen(listener, 64) == 0);
+        CHECK(getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+        port = ntohs(addr.sin_port);
+        engine = EngineFactory::createEngine(engineName, Engine::Context{listener, 2, processor, stats, false, QueueLimits{}});
+        processor.setEngineName(engine->name());
+        engine->start();
+    }
+
+    ~TestServer() {
+        shutdown(listener, SHUT_RDWR);
+        engine->stop();
+        close(listener);
+    }
+
+    bool run(const std::string& line) { return processor.execute(processor.parse(line)).ok; }
+
+    // Connects a client; a small receive buffer keeps the kernel from absorbing the responses
+    int connectClient(int receiveBuffer = 0) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (receiveBuffer > 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof receiveBuffer);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        CHECK(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) == 0);
+        return fd;
+    }
+
+    // The number Stats reports right after label, 0 if it reports no such line
+    uint64_t counter(const std::string& label) const {
+        std::string report = stats.report("");
+        size_t at = report.find(label);
+        return at == std::string::npos ? 0 : std::stoull(report.substr(at + label.size()));
+    }
+
+    std::string name() const { return engine->name(); }
+
+private:
+    Instrumentation stats;
+    CommandProcessor processor;
+    int listener;
+    int port = 0;
+    std::unique_ptr<Engine> engine;
+};
+
+inline bool waitFor(int fd, short events, int timeoutMs) {
+    pollfd p{fd, events, 0};
+    return poll(&p, 1, timeoutMs) > 0;
+}
+
+#endif // TEST_SERVER_HPP
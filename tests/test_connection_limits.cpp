@@ -0,0 +1,143 @@
+// Per-connection memory bounds, through real engines on a loopback listener: a client that
+// pipelines RunMST edge lists without reading makes the reactors stop reading it once its unsent
+// output is full, and still gets every answer once it reads; a line past the maximum length is
+// answered with an error, after the responses before it, and the connection is closed.
+#include <cerrno>
+#include <string>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Check.hpp"
+#include "LineBuffer.hpp"
+#include "TestServer.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+const char* const OK = "Command processed successfully\n";
+
+// Occurrences of `marker` in a stream read in pieces, without keeping the stream
+class Counter {
+public:
+    explicit Counter(const std::string& marker) : marker(marker) {}
+
+    void feed(const char* bytes, size_t n) {
+        tail.append(bytes, n);
+        size_t at = 0;
+        while ((at = tail.find(marker, at)) != std::string::npos) {
+            ++count;
+            at += marker.size();
+        }
+        size_t keep = std::min(tail.size(), marker.size() - 1);
+        tail.erase(0, tail.size() - keep);
+    }
+
+    size_t count = 0;
+
+private:
+    std::string marker;
+    std::string tail;
+};
+
+void testOutputBound(const std::string& engineName) {
+    TestServer server(engineName);
+    std::string graph = "NewGraph 200 199";
+    for (int v = 1; v < 200; ++v) graph += " " + std::to_string(v) + "," + std::to_string(v + 1) + "," + std::to_string(v);
+    CHECK(server.run(graph));
+
+    // Pipeline edge lists without reading until the server stops taking them. Lines are padded
+    // so the bytes the kernel and the uring receive buffers soak up are a few thousand commands.
+    int fd = server.connectClient(4096);
+    std::string run = "RunMST Kruskal edges" + std::string(1000, ' ') + "\n";
+    size_t lineSize = run.size();
+    std::string burst;
+    for (int k = 0; k < 64; ++k) burst += run;
+    size_t sent = 0;
+    const size_t limit = size_t(64) << 20;
+    while (sent < limit) {
+        ssize_t n = send(fd, burst.data() + sent % burst.size(), burst.size() - sent % burst.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!waitFor(fd, POLLOUT, 500)) break;
+        } else if (n < 0 && errno != EINTR) {
+            break;
+        }
+    }
+    if (sent >= limit) std::cerr << server.name() << " kept reading a client that does not read\n";
+    CHECK(sent < limit);
+    CHECK(server.counter("Backpressure: ") > 0);
+
+    // Once the server settles, it has run no more commands than its output bound holds, about
+    // 2 KB each, plus what the socket buffers took
+    uint64_t ran = server.counter("RunMST: count=");
+    for (uint64_t last = ran + 1; ran != last; ran = server.counter("RunMST: count=")) {
+        last = ran;
+        usleep(300000);
+    }
+    if (ran > 8000) std::cerr << server.name() << " ran " << ran << " of " << sent / lineSize << " commands unread\n";
+    CHECK(ran <= 8000);
+
+    // Read, finishing the last line on the way: every command is answered and the connection closes
+    std::string rest = run.substr(sent % lineSize);
+    if (rest.size() == lineSize) rest.clear();
+    sent += rest.size();
+    if (rest.empty()) shutdown(fd, SHUT_WR);
+    Counter answers(OK);
+    char buf[65536];
+    while (true) {
+        pollfd p{fd, short(POLLIN | (rest.empty() ? 0 : POLLOUT)), 0};
+        if (poll(&p, 1, 10000) <= 0) break;
+        if (p.revents & POLLOUT) {
+            ssize_t n = send(fd, rest.data(), rest.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n > 0) rest.erase(0, n);
+            if (rest.empty()) shutdown(fd, SHUT_WR);
+        }
+        if (p.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = recv(fd, buf, sizeof buf, 0);
+            if (n <= 0) break;
+            answers.feed(buf, n);
+        }
+    }
+    if (answers.count != sent / lineSize) {
+        std::cerr << server.name() << ": " << answers.count << " answers to " << sent / lineSize << " commands\n";
+    }
+    CHECK(answers.count == sent / lineSize);
+    close(fd);
+}
+
+void testLineCap(const std::string& engineName) {
+    TestServer server(engineName);
+    CHECK(server.run("NewGraph 3 1 1,3,1"));
+    int fd = server.connectClient();
+    std::string request = "NewEdge 1,2,3\n" + std::string(size_t(2) << 20, 'x');
+    size_t sent = 0;
+    while (sent < request.size()) {
+        ssize_t n = send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;  // Closed by the server partway
+        sent += n;
+    }
+    std::string received;
+    char buf[4096];
+    while (waitFor(fd, POLLIN, 10000)) {
+        ssize_t n = recv(fd, buf, sizeof buf, 0);
+        if (n <= 0) break;
+        received.append(buf, n);
+    }
+    std::string expected = std::string(OK) + Engine::LINE_TOO_LONG_RESPONSE;
+    if (received != expected) std::cerr << server.name() << " answered \"" << received << "\"\n";
+    CHECK(received == expected);
+    close(fd);
+}
+
+} // namespace
+
+int main() {
+    ThreadPool::configure(2);
+    for (const char* engine : {"reactor", "reactor-pool", "uring", "uring-pool"}) testOutputBound(engine);
+    LineBuffer::configureMaxLine(size_t(1) << 20);
+    for (const char* engine : {"leader-followers", "pipeline", "reactor", "reactor-pool", "coroutine", "uring", "uring-pool"}) {
+        testLineCap(engine);
+    }
+    return checkResult("test_connection_limits");
+}
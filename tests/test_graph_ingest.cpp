@@ -0,0 +1,106 @@
+// Ingest reduction: edges are undirected, so a repeat in the reverse direction collapses like any
+// other parallel edge in NewGraph lists, NewEdge upserts, RemoveEdge and loaded files, and the
+// counters say what was removed or replaced.
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "Check.hpp"
+#include "Graph.hpp"
+#include "GraphFile.hpp"
+
+namespace {
+
+using EdgeSet = std::vector<std::tuple<int, int, int>>;
+
+EdgeSet edgesOf(const Graph& graph) {
+    EdgeSet edges;
+    graph.visitEdges([&edges](const auto& view) {
+        view.forEachEdge([&edges](int u, int v, int w) { edges.emplace_back(u, v, w); });
+    });
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+bool isMapped(const Graph& graph) {
+    bool mapped = false;
+    graph.visitEdges([&mapped](const auto& view) {
+        mapped = std::is_same_v<std::decay_t<decltype(view)>, MappedView>;
+    });
+    return mapped;
+}
+
+bool run(Graph& graph, const std::string& line) { return graph.eval(graph.parse(line)); }
+
+void testEdgeLists() {
+    Graph graph;
+    CHECK(run(graph, "NewGraph 4 6 1,2,5 2,1,3 3,4,7 4,3,9 2,2,1 1,3,4"));
+    CHECK(graph.getNumEdges() == 3);
+    CHECK(edgesOf(graph) == (EdgeSet{{0, 1, 3}, {0, 2, 4}, {2, 3, 7}}));
+    const Graph::IngestStats& ingest = graph.getIngestStats();
+    CHECK(ingest.received == 6);
+    CHECK(ingest.parallelCollapsed == 2);
+    CHECK(ingest.selfLoopsDropped == 1);
+    CHECK(ingest.weightsReplaced == 0);
+}
+
+void testMutations() {
+    Graph graph;
+    CHECK(run(graph, "NewGraph 4 1 1,2,5"));
+    CHECK(run(graph, "NewEdge 2,1,8"));  // The same edge: the weight is replaced, not doubled
+    CHECK(graph.getNumEdges() == 1);
+    CHECK(edgesOf(graph) == (EdgeSet{{0, 1, 8}}));
+    CHECK(graph.getIngestStats().weightsReplaced == 1);
+    CHECK(run(graph, "NewEdge 3,1,2"));
+    CHECK(graph.getIngestStats().weightsReplaced == 1);
+    CHECK(run(graph, "RemoveEdge 1,3"));  // Added as 3,1
+    CHECK(run(graph, "RemoveEdge 2,1"));  // Added as 1,2
+    CHECK(graph.getNumEdges() == 0);
+    CHECK(edgesOf(graph).empty());
+}
+
+void testLoadedFiles(const std::string& root) {
+    CHECK(DataDirectory::active().configure(root));
+
+    // As SaveGraph writes it, every edge once in its lower endpoint's row: read in place
+    Graph saved;
+    CHECK(run(saved, "NewGraph 4 3 2,1,5 3,2,6 4,3,7"));
+    CHECK(saved.SaveGraph(root + "/canonical"));
+    Graph graph;
+    CHECK(run(graph, "LoadGraph canonical"));
+    CHECK(isMapped(graph));
+    CHECK(edgesOf(graph) == edgesOf(saved));
+    CHECK(graph.getIngestStats().parallelCollapsed == 0);
+
+    // Written by another tool with both directions and a repeat in one row: collapsed on load
+    std::vector<std::vector<std::pair<int, int>>> adj(3);
+    adj[0] = {{1, 5}, {2, 9}, {2, 4}};
+    adj[1] = {{0, 3}};
+    adj[2] = {{0, 6}};
+    CHECK(writeGraphFile(root + "/multigraph", adj));
+    CHECK(run(graph, "LoadGraph multigraph"));
+    CHECK(!isMapped(graph));
+    CHECK(graph.getNumEdges() == 2);
+    CHECK(edgesOf(graph) == (EdgeSet{{0, 1, 3}, {0, 2, 4}}));
+    CHECK(graph.getIngestStats().received == 5);
+    CHECK(graph.getIngestStats().parallelCollapsed == 3);
+}
+
+} // namespace
+
+int main() {
+    testEdgeLists();
+    testMutations();
+    char pattern[] = "/tmp/mst_ingest_test_XXXXXX";
+    const char* made = mkdtemp(pattern);
+    CHECK(made != nullptr);
+    if (made) {
+        std::string root = made;
+        testLoadedFiles(root);
+        std::string cleanup = "rm -rf '" + root + "'";
+        CHECK(std::system(cleanup.c_str()) == 0);
+    }
+    return checkResult("test_graph_ingest");
+}
@@ -0,0 +1,148 @@
+// Path queries against brute force: on random forests, TreePathIndex answers connectivity, path
+// distance and the heaviest path edge the same as a walk from the queried vertex, including tall
+// trees that need every lifting level and negative weights.
+#include <cstdint>
+#include <vector>
+#include "Check.hpp"
+#include "MST.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+#include "TreePathIndex.hpp"
+
+namespace {
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+    int below(int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((state >> 33) % static_cast<uint64_t>(bound));
+    }
+
+private:
+    uint64_t state;
+};
+
+// Random forest: each vertex after the first joins one of the `reach` vertices before it unless
+// it starts a new tree, so a small reach makes tall trees; ids are shuffled
+MST randomForest(int n, int treeOdds, int reach, int minWeight, int maxWeight, Random& random) {
+    std::vector<int> id(n);
+    for (int v = 0; v < n; ++v) id[v] = v;
+    for (int v = n - 1; v > 0; --v) std::swap(id[v], id[random.below(v + 1)]);
+    MST forest(n);
+    for (int v = 1; v < n; ++v) {
+        if (random.below(treeOdds) == 0) continue;
+        int w = minWeight + random.below(maxWeight - minWeight + 1);
+        int parent = v - 1 - random.below(std::min(v, reach));
+        forest.addEdge(id[parent], id[v], w);
+    }
+    return forest;
+}
+
+// The forest walked from one vertex: parents, distances, the heaviest edge on each path, and
+// preorder positions with subtree sizes to tell whether an edge lies on a path
+struct Walk {
+    std::vector<bool> reached;
+    std::vector<int> parent;        // -1 for the start and for vertices it does not reach
+    std::vector<int> parentWeight;
+    std::vector<int64_t> dist;
+    std::vector<int> heaviest;
+    std::vector<int> preorder;
+    std::vector<int> size;
+
+    // Whether x is v or one of the vertices above it
+    bool above(int x, int v) const { return preorder[x] <= preorder[v] && preorder[v] < preorder[x] + size[x]; }
+};
+
+Walk walkFrom(const std::vector<std::vector<std::pair<int, int>>>& adj, int s) {
+    int n = static_cast<int>(adj.size());
+    Walk walk{std::vector<bool>(n, false), std::vector<int>(n, -1), std::vector<int>(n, 0), std::vector<int64_t>(n, 0),
+              std::vector<int>(n, 0), std::vector<int>(n, -1), std::vector<int>(n, 1)};
+    std::vector<int> order, stack(1, s);
+    walk.reached[s] = true;
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        walk.preorder[u] = static_cast<int>(order.size());
+        order.push_back(u);
+        for (auto [v, w] : adj[u]) {
+            if (walk.reached[v]) continue;
+            walk.reached[v] = true;
+            walk.parent[v] = u;
+            walk.parentWeight[v] = w;
+            walk.dist[v] = walk.dist[u] + w;
+            walk.heaviest[v] = u == s ? w : std::max(walk.heaviest[u], w);
+            stack.push_back(v);
+        }
+    }
+    for (size_t i = order.size(); i-- > 1;) walk.size[walk.parent[order[i]]] += walk.size[order[i]];
+    return walk;
+}
+
+void check(const MST& forest, int sources, Random& random) {
+    int n = forest.getNumVertices();
+    TreePathIndex index;
+    index.build(forest, SolverWorkspace::forThisThread().arena, ThreadPool::shared());
+    CHECK(index.getNumVertices() == n);
+
+    std::vector<std::vector<std::pair<int, int>>> adj(n);
+    for (const MSTEdge& e : forest.getEdges()) {
+        adj[e.from].push_back({e.to, e.weight});
+        adj[e.to].push_back({e.from, e.weight});
+    }
+    for (int round = 0; round < sources; ++round) {
+        int u = random.below(n);
+        Walk walk = walkFrom(adj, u);
+        bool agrees = true;
+        for (int v = 0; v < n; ++v) {
+            bool reached = walk.reached[v];
+            agrees = agrees && index.connected(u, v) == reached;
+            if (!reached) {
+                MSTEdge edge;
+                agrees = agrees && !index.maxEdge(u, v, edge);
+                continue;
+            }
+            agrees = agrees && index.distance(u, v) == walk.dist[v];
+
+            // The reported edge must be a path edge, its lower end at or above v, with the
+            // heaviest weight on the path
+            MSTEdge edge{-1, -1, 0};
+            bool found = index.maxEdge(u, v, edge);
+            agrees = agrees && found == (u != v);
+            if (!found) continue;
+            int lower = edge.from >= 0 && edge.from < n && walk.parent[edge.from] == edge.to ? edge.from
+                      : edge.to >= 0 && edge.to < n && walk.parent[edge.to] == edge.from ? edge.to : -1;
+            bool onPath = lower != -1 && walk.parentWeight[lower] == edge.weight && walk.above(lower, v);
+            agrees = agrees && edge.weight == walk.heaviest[v] && onPath;
+        }
+        CHECK(agrees);
+    }
+}
+
+} // namespace
+
+int main() {
+    ThreadPool::configure(4);
+    Random random(38);
+    for (int round = 0; round < 40; ++round) {
+        MST forest = randomForest(1 + random.below(300), 1 + random.below(20), 1 + random.below(8), 0, 1000, random);
+        check(forest, 10, random);
+    }
+    for (int round = 0; round < 20; ++round) {
+        MST forest = randomForest(1 + random.below(300), 8, 4, -50, 50, random);
+        check(forest, 10, random);
+    }
+    // Chains rooted at one end whose height is exactly a power of two, the deepest climb each
+    // lifting table must cover
+    for (int height = 1; height <= 1024; height *= 2) {
+        MST chain(height + 1);
+        for (int v = 1; v <= height; ++v) chain.addEdge(v - 1, v, random.below(100));
+        check(chain, 4, random);
+    }
+    // A path of 5000 vertices uses every lifting level; a bushy forest of 20000 splits the build
+    MST path = randomForest(5000, 1000000, 1, -1000, 1000, random);
+    check(path, 20, random);
+    MST bushy = randomForest(20000, 500, 2000, 1, 1000000, random);
+    check(bushy, 20, random);
+    return checkResult("test_path_queries");
+}
@@ -0,0 +1,82 @@
+// RunMST coalescing through the pooled engines, on two pool workers: while one connection holds
+// the graph lock with a long solve, many connections ask for the same RunMST. One of them solves
+// and the rest attach to it without taking a worker, so a command that needs no lock is still
+// answered before the long solve ends, and every attached request gets the one solve's answer.
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Check.hpp"
+#include "TestServer.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+const size_t CLIENTS = 48;
+
+void sendLine(int fd, const std::string& line) {
+    std::string request = line + "\n";
+    CHECK(send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size()));
+}
+
+// Everything the server sends until it closes the connection
+std::string readAll(int fd) {
+    std::string received;
+    char buf[4096];
+    while (waitFor(fd, POLLIN, 30000)) {
+        ssize_t n = recv(fd, buf, sizeof buf, 0);
+        if (n <= 0) break;
+        received.append(buf, n);
+    }
+    return received;
+}
+
+bool answered(const std::string& response) { return response.rfind("Command processed successfully\n", 0) == 0; }
+
+void testCoalescing(const std::string& engineName) {
+    TestServer server(engineName);
+    CHECK(server.run("GenerateGraph random 1000000 4000000 45"));
+
+    // Kruskal sorts four million edges under the graph lock, on one of the two workers
+    int holder = server.connectClient();
+    sendLine(holder, "RunMST Kruskal");
+    shutdown(holder, SHUT_WR);
+    usleep(50000);
+
+    std::vector<int> clients;
+    for (size_t c = 0; c < CLIENTS; ++c) {
+        clients.push_back(server.connectClient());
+        sendLine(clients.back(), "RunMST Prim");
+        shutdown(clients.back(), SHUT_WR);
+    }
+
+    // An invalid listing fails before any lock. Parked on the graph lock, the attached requests
+    // would hold the other worker and this would wait for Kruskal to finish.
+    int probe = server.connectClient();
+    sendLine(probe, "RunMST Prim edges bogus");
+    shutdown(probe, SHUT_WR);
+    CHECK(readAll(probe) == "Command processing failed\n");
+    bool holderDone = waitFor(holder, POLLIN, 0);
+    if (holderDone) std::cerr << server.name() << " answered the probe only after the lock holder\n";
+    CHECK(!holderDone);
+
+    CHECK(answered(readAll(holder)));
+    std::string first = readAll(clients[0]);
+    CHECK(answered(first));
+    for (size_t c = 1; c < clients.size(); ++c) CHECK(readAll(clients[c]) == first);
+    uint64_t coalesced = server.counter("Coalesced: ");
+    if (coalesced != CLIENTS - 1) std::cerr << server.name() << " coalesced " << coalesced << " of " << CLIENTS << "\n";
+    CHECK(coalesced == CLIENTS - 1);
+
+    close(holder);
+    close(probe);
+    for (int fd : clients) close(fd);
+}
+
+} // namespace
+
+int main() {
+    ThreadPool::configure(3);  // The caller and two workers
+    for (const char* engine : {"reactor-pool", "uring-pool", "coroutine"}) testCoalescing(engine);
+    return checkResult("test_run_coalescing");
+}
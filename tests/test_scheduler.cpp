@@ -0,0 +1,143 @@
+// Fork/join scheduler and the Chase-Lev deque under it: every index of a loop runs exactly once
+// whatever the grain, nesting or number of outside callers, a throwing body reaches the caller
+// after the loop is joined, and concurrent pops and steals never hand out an entry twice.
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "ChaseLevDeque.hpp"
+#include "Check.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+void testCoverage(ThreadPool& pool) {
+    for (size_t count : {size_t(1), size_t(7), size_t(1000), size_t(100003)}) {
+        for (size_t grain : {size_t(0), size_t(1), size_t(64)}) {
+            std::vector<std::atomic<int>> hits(count);
+            pool.parallelFor(count, [&hits](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+            }, grain);
+            bool once = true;
+            for (const auto& hit : hits) once = once && hit.load() == 1;
+            CHECK(once);
+        }
+    }
+}
+
+// Loops forked from inside pool tasks run on the same deques
+void testNested(ThreadPool& pool) {
+    const size_t OUTER = 64, INNER = 2000;
+    std::vector<std::atomic<int>> hits(OUTER * INNER);
+    pool.parallelFor(OUTER, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallelFor(INNER, [&hits, i, INNER](size_t b, size_t e) {
+                for (size_t j = b; j < e; ++j) hits[i * INNER + j].fetch_add(1, std::memory_order_relaxed);
+            }, 16);
+        }
+    }, 1);
+    bool once = true;
+    for (const auto& hit : hits) once = once && hit.load() == 1;
+    CHECK(once);
+}
+
+// Several outside threads borrow guest deques at the same time
+void testGuests(ThreadPool& pool) {
+    const int CALLERS = 6;
+    const size_t COUNT = 50000;
+    std::vector<long long> sums(CALLERS, 0);
+    std::vector<std::thread> callers;
+    for (int c = 0; c < CALLERS; ++c) {
+        callers.emplace_back([&pool, &sums, c, COUNT] {
+            for (int round = 0; round < 20; ++round) {
+                std::atomic<long long> sum{0};
+                pool.parallelFor(COUNT, [&sum](size_t begin, size_t end) {
+                    long long local = 0;
+                    for (size_t i = begin; i < end; ++i) local += static_cast<long long>(i);
+                    sum.fetch_add(local, std::memory_order_relaxed);
+                }, 128);
+                sums[c] += sum.load();
+            }
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+    long long expected = 20LL * static_cast<long long>(COUNT) * (COUNT - 1) / 2;
+    for (long long sum : sums) CHECK(sum == expected);
+}
+
+// The loop is fully joined before the exception leaves parallelFor, so the pool stays usable
+void testExceptions(ThreadPool& pool) {
+    for (int round = 0; round < 50; ++round) {
+        std::atomic<int> ran{0};
+        bool caught = false;
+        try {
+            pool.parallelFor(4096, [&ran, round](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    ran.fetch_add(1, std::memory_order_relaxed);
+                    if (i == static_cast<size_t>(round * 79 % 4096)) throw std::runtime_error("body");
+                }
+            }, 8);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(ran.load() > 0);
+    }
+    testCoverage(pool);
+
+    std::atomic<int> done{0};
+    pool.submit([] { throw std::runtime_error("expected by the test: submitted task failed"); });
+    pool.submit([&done] { done = 1; });
+    while (done.load() == 0) std::this_thread::yield();
+    CHECK(done.load() == 1);
+}
+
+// The owner pushes and pops while thieves steal; every entry must be taken exactly once
+void testDeque() {
+    const int ITEMS = 100000, THIEVES = 3;
+    std::vector<int> items(ITEMS);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    ChaseLevDeque<int, 64> deque;
+    std::atomic<bool> producing{true};
+
+    auto take = [&](int* item) { taken[item - items.data()].fetch_add(1, std::memory_order_relaxed); };
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < THIEVES; ++t) {
+        thieves.emplace_back([&] {
+            while (producing.load(std::memory_order_acquire) || !deque.empty()) {
+                if (int* item = deque.steal()) take(item);
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    int next = 0;
+    while (next < ITEMS) {
+        if (deque.push(&items[next])) ++next;
+        else std::this_thread::yield();
+        if (next % 2 == 0) {
+            if (int* item = deque.pop()) take(item);
+        }
+    }
+    while (int* item = deque.pop()) take(item);
+    producing.store(false, std::memory_order_release);
+    for (std::thread& thief : thieves) thief.join();
+    while (int* item = deque.steal()) take(item);
+
+    bool once = true;
+    for (const auto& count : taken) once = once && count.load() == 1;
+    CHECK(once);
+    CHECK(deque.empty());
+}
+
+} // namespace
+
+int main() {
+    ThreadPool pool(4);
+    testCoverage(pool);
+    testNested(pool);
+    testGuests(pool);
+    testExceptions(pool);
+    testDeque();
+    return checkResult("test_scheduler");
+}
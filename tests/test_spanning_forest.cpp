@@ -0,0 +1,158 @@
+// Minimum spanning forests against a sequential reference: on random graphs with many components,
+// every algorithm finds the components the lock-free union-find should, each rooted at its lowest
+// vertex with the right size, and a forest of minimum weight per component. The graphs are solved
+// over and over on four pool threads so the concurrent hooking and path halving get exercised.
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Check.hpp"
+#include "Graph.hpp"
+#include "MSTFactory.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+    int below(int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((state >> 33) % static_cast<uint64_t>(bound));
+    }
+
+private:
+    uint64_t state;
+};
+
+class DisjointSets {
+public:
+    explicit DisjointSets(int n) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+    int find(int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    }
+    bool unite(int u, int v) {
+        u = find(u);
+        v = find(v);
+        if (u == v) return false;
+        parent[std::max(u, v)] = std::min(u, v);
+        return true;
+    }
+
+private:
+    std::vector<int> parent;
+};
+
+// Vertices are split into groups by a random cut, and edges only join vertices of one group, so
+// the graph has at least as many components as groups, plus whatever the edges leave apart
+Graph randomGraph(int n, int groups, int m, int minWeight, int maxWeight, Random& random) {
+    std::vector<int> group(n);
+    for (int v = 0; v < n; ++v) group[v] = random.below(groups);
+    std::vector<std::vector<int>> members(groups);
+    for (int v = 0; v < n; ++v) members[group[v]].push_back(v);
+    Graph graph;
+    graph.NewGraph(n, 0);
+    for (int k = 0; k < m; ++k) {
+        const std::vector<int>& in = members[random.below(groups)];
+        if (in.size() < 2) continue;
+        int u = in[random.below(static_cast<int>(in.size()))];
+        int v = in[random.below(static_cast<int>(in.size()))];
+        if (u == v) continue;
+        graph.NewEdge(u + 1, v + 1, minWeight + random.below(maxWeight - minWeight + 1));
+    }
+    return graph;
+}
+
+// Kruskal over the stored edges, summarised like MST::getComponents()
+std::vector<ComponentStats> reference(const Graph& graph) {
+    using Edge = std::tuple<int, int, int>;
+    std::vector<Edge> edges;
+    graph.visitEdges([&edges](const auto& view) {
+        view.forEachEdge([&edges](int u, int v, int w) { edges.emplace_back(w, u, v); });
+    });
+    std::sort(edges.begin(), edges.end());
+    int n = graph.getNumVertices();
+    DisjointSets sets(n);
+    std::vector<int64_t> weight(n, 0);
+    for (auto [w, u, v] : edges) {
+        if (sets.unite(u, v)) weight[u] += w;  // Moved to the root below
+    }
+    std::vector<ComponentStats> components;
+    std::vector<int> index(n, -1);
+    for (int v = 0; v < n; ++v) {
+        int root = sets.find(v);
+        if (root == v) {
+            index[v] = static_cast<int>(components.size());
+            components.push_back({v, 0, 0});
+        }
+        ComponentStats& component = components[index[root]];
+        ++component.vertices;
+        component.totalWeight += weight[v];
+    }
+    return components;
+}
+
+bool sameComponents(const std::vector<ComponentStats>& a, const std::vector<ComponentStats>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t c = 0; c < a.size(); ++c) {
+        if (a[c].root != b[c].root || a[c].vertices != b[c].vertices || a[c].totalWeight != b[c].totalWeight) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The edges form a forest with the expected trees: no cycle, every edge inside one component,
+// and the per-tree weights of the summary
+bool isForest(const MST& forest, const std::vector<ComponentStats>& expected) {
+    int n = forest.getNumVertices();
+    DisjointSets sets(n);
+    for (const MSTEdge& e : forest.getEdges()) {
+        if (e.from < 0 || e.from >= n || e.to < 0 || e.to >= n || !sets.unite(e.from, e.to)) return false;
+    }
+    std::vector<int64_t> weight(n, 0);
+    for (const MSTEdge& e : forest.getEdges()) weight[sets.find(e.from)] += e.weight;
+    for (const ComponentStats& component : expected) {
+        if (weight[component.root] != component.totalWeight) return false;
+    }
+    return forest.getEdges().size() == static_cast<size_t>(n) - expected.size();
+}
+
+void check(const Graph& graph, bool negative) {
+    std::vector<ComponentStats> expected = reference(graph);
+    for (const MSTFactory::Entry& entry : MSTFactory::REGISTRY) {
+        if (negative && std::string(entry.name) == "Integer") continue;
+        MST forest;
+        entry.create()->solve(graph, SolverWorkspace::forThisThread(), forest);
+        bool matches = sameComponents(forest.getComponents(), expected) && isForest(forest, expected);
+        if (!matches) std::cerr << entry.name << " disagrees with the reference\n";
+        CHECK(matches);
+    }
+}
+
+} // namespace
+
+int main() {
+    ThreadPool::configure(4);
+    Random random(34);
+    for (int round = 0; round < 200; ++round) {
+        int n = 1 + random.below(500);
+        Graph graph = randomGraph(n, 1 + random.below(40), random.below(3 * n), 0, 1000, random);
+        check(graph, false);
+    }
+    for (int round = 0; round < 50; ++round) {
+        int n = 1 + random.below(500);
+        Graph graph = randomGraph(n, 1 + random.below(10), random.below(3 * n), -500, 500, random);
+        check(graph, true);
+    }
+    // Large enough that the components pass is split into many chunks per thread
+    for (int round = 0; round < 5; ++round) {
+        Graph graph = randomGraph(50000, 200, 120000, 0, 1000000, random);
+        check(graph, false);
+    }
+    return checkResult("test_spanning_forest");
+}
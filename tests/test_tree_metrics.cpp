@@ -0,0 +1,108 @@
+// Euler tour distance metrics against brute force: on random forests, the longest and average
+// distance over connected vertex pairs match a walk from every vertex, for positive weights,
+// zero weights, and negative weights, which take the per-tree fallback.
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Check.hpp"
+#include "MST.hpp"
+#include "SolverWorkspace.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+    int below(int bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((state >> 33) % static_cast<uint64_t>(bound));
+    }
+
+private:
+    uint64_t state;
+};
+
+// Random forest: each vertex after the first joins an earlier one unless it starts a new tree,
+// with vertex ids shuffled so trees are not contiguous ranges
+MST randomForest(int n, int treeOdds, int minWeight, int maxWeight, Random& random) {
+    std::vector<int> id(n);
+    for (int v = 0; v < n; ++v) id[v] = v;
+    for (int v = n - 1; v > 0; --v) std::swap(id[v], id[random.below(v + 1)]);
+    MST forest(n);
+    for (int v = 1; v < n; ++v) {
+        if (random.below(treeOdds) == 0) continue;
+        int w = minWeight + random.below(maxWeight - minWeight + 1);
+        forest.addEdge(id[random.below(v)], id[v], w);
+    }
+    return forest;
+}
+
+void bruteForce(const MST& forest, int64_t& longest, double& average) {
+    int n = forest.getNumVertices();
+    std::vector<std::vector<std::pair<int, int>>> adj(n);
+    for (const MSTEdge& e : forest.getEdges()) {
+        adj[e.from].push_back({e.to, e.weight});
+        adj[e.to].push_back({e.from, e.weight});
+    }
+    longest = 0;
+    long double sum = 0;
+    long double pairs = 0;
+    std::vector<int64_t> dist(n);
+    std::vector<int> parent(n), stack;
+    for (int s = 0; s < n; ++s) {
+        stack.assign(1, s);
+        parent[s] = -1;
+        dist[s] = 0;
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            if (u > s) {
+                longest = std::max(longest, dist[u]);
+                sum += dist[u];
+                pairs += 1;
+            }
+            for (auto [v, w] : adj[u]) {
+                if (v == parent[u]) continue;
+                parent[v] = u;
+                dist[v] = dist[u] + w;
+                stack.push_back(v);
+            }
+        }
+    }
+    average = pairs > 0 ? static_cast<double>(sum / pairs) : 0.0;
+}
+
+void check(MST& forest) {
+    forest.calculateDistances(SolverWorkspace::forThisThread());
+    int64_t longest;
+    double average;
+    bruteForce(forest, longest, average);
+    CHECK(forest.getLongestDistance() == longest);
+    CHECK(std::fabs(forest.getAverageDistance() - average) <= 1e-9 * std::max(1.0, std::fabs(average)));
+}
+
+} // namespace
+
+int main() {
+    ThreadPool::configure(4);
+    Random random(37);
+    for (int round = 0; round < 40; ++round) {
+        int n = 1 + random.below(400);
+        MST forest = randomForest(n, 1 + random.below(20), 0, 1000, random);
+        check(forest);
+    }
+    for (int round = 0; round < 20; ++round) {
+        MST forest = randomForest(1 + random.below(300), 8, -50, 50, random);
+        check(forest);
+    }
+    // Long trees, so a chunk of the tour scan starts and ends inside one tree
+    MST large = randomForest(4000, 1000, 1, 100, random);
+    int64_t longest;
+    double average;
+    large.calculateDistances(SolverWorkspace::forThisThread());
+    bruteForce(large, longest, average);
+    CHECK(large.getLongestDistance() == longest);
+    CHECK(std::fabs(large.getAverageDistance() - average) <= 1e-9 * average);
+    return checkResult("test_tree_metrics");
+}